@@ -0,0 +1,100 @@
+//
+//  band_workers.cpp
+//  GameOfLive
+//
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "band_workers.h"
+
+/**
+ * Pins the current thread to the CPU of the band, bands are spread over all
+ * CPUs, so they get into all NUMA nodes. Failure is ignored.
+ */
+static void pinToBandCpu(size_t band, size_t bands) {
+#ifdef __linux__
+  const size_t cpus = std::thread::hardware_concurrency();
+  if (cpus == 0)
+    return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(band * cpus / bands, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+BandWorkers::BandWorkers() {
+  setThreads(0);
+}
+
+BandWorkers::~BandWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread& worker : workers)
+    worker.join();
+}
+
+BandWorkers& BandWorkers::getInstance() {
+  static BandWorkers instance;
+  return instance;
+}
+
+size_t BandWorkers::getThreads() const {
+  return threads;
+}
+
+void BandWorkers::setThreads(size_t threads) {
+  std::lock_guard<std::mutex> lock(runMutex);
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  this->threads = threads == 0 ? 1 : threads;
+}
+
+size_t BandWorkers::getBandsCount(size_t words) const {
+  size_t bands = words / MIN_BAND_WORDS;
+  if (bands > threads)
+    bands = threads;
+  return bands == 0 ? 1 : bands;
+}
+
+void BandWorkers::run(size_t bands, const std::function<void(size_t)>& task) {
+  std::lock_guard<std::mutex> runLock(runMutex);
+  std::unique_lock<std::mutex> lock(mutex);
+  // Threads are started once, the same band index gets the same thread
+  while (workers.size() < bands)
+    workers.push_back(
+        std::thread(&BandWorkers::work, this, workers.size(), threads));
+
+  this->task = &task;
+  this->bands = bands;
+  remaining = bands;
+  generation++;
+  wake.notify_all();
+  done.wait(lock, [this] { return remaining == 0; });
+  this->task = nullptr;
+}
+
+void BandWorkers::work(size_t band, size_t threads) {
+  pinToBandCpu(band, threads);
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [&] { return stopping || generation != seen; });
+    if (stopping)
+      return;
+    seen = generation;
+    if (band >= bands)
+      continue;
+
+    const std::function<void(size_t)>& current = *task;
+    lock.unlock();
+    current(band);
+    lock.lock();
+    if (--remaining == 0)
+      done.notify_all();
+  }
+}
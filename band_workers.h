@@ -0,0 +1,108 @@
+//
+//  band_workers.h
+//  GameOfLive
+//
+
+#ifndef BAND_WORKERS_H
+#define BAND_WORKERS_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Minimum number of memory words in the band worth of its own thread.
+const size_t MIN_BAND_WORDS = 1 << 16;
+
+/**
+ * Persistent threads, which process bands of large fields. Each band is always
+ * processed by the same thread, pinned to its own CPU, so memory first touched
+ * by the band thread stays local to its NUMA node during steps.
+ */
+class BandWorkers {
+ public:
+  static BandWorkers& getInstance();
+
+  ~BandWorkers();
+
+  /**
+   * @return Maximum number of bands, by default number of cores.
+   */
+  size_t getThreads() const;
+
+  /**
+   * Sets maximum number of bands, if zero, number of cores is used.
+   */
+  void setThreads(size_t threads);
+
+  /**
+   * @return Number of bands for processing of the given memory words.
+   */
+  size_t getBandsCount(size_t words) const;
+
+  /**
+   * Calls the task for each band index from the band thread and waits for all
+   * of them. Calls from several threads are serialized.
+   */
+  void run(size_t bands, const std::function<void(size_t)>& task);
+
+ private:
+  size_t threads;
+  std::vector<std::thread> workers;
+
+  std::mutex runMutex;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  const std::function<void(size_t)>* task = nullptr;
+  size_t bands = 0;
+  size_t remaining = 0;
+  uint64_t generation = 0;
+  bool stopping = false;
+
+  BandWorkers();
+
+  BandWorkers(const BandWorkers&) = delete;
+
+  BandWorkers& operator=(const BandWorkers&) = delete;
+
+  /**
+   * Waits for tasks and processes the band of each one.
+   *
+   * @param threads Number of threads, among which CPUs are spread.
+   */
+  void work(size_t band, size_t threads);
+};
+
+/**
+ * Splits range [0, size) into bands of equal size aligned to the alignment and
+ * calls function(band, begin, end) for each band from its band thread.
+ * Small ranges are processed at once from the calling thread.
+ *
+ * @param words Memory words of the whole range, defines number of bands.
+ */
+template <typename Function>
+void runInBands(size_t size,
+                size_t alignment,
+                size_t words,
+                Function function) {
+  BandWorkers& workers = BandWorkers::getInstance();
+  const size_t chunks = (size + alignment - 1) / alignment;
+  size_t bands = workers.getBandsCount(words);
+  if (bands > chunks)
+    bands = chunks;
+  if (bands <= 1) {
+    function(0, 0, size);
+    return;
+  }
+  workers.run(bands, [&](size_t band) {
+    size_t begin = chunks * band / bands * alignment;
+    size_t end = chunks * (band + 1) / bands * alignment;
+    function(band, begin < size ? begin : size, end < size ? end : size);
+  });
+}
+
+#endif /* BAND_WORKERS_H */
@@ -0,0 +1,100 @@
+//
+//  bench_access.cpp
+//  GameOfLiveBenchmarks
+//
+
+#include <string>
+
+#include "benchmark.h"
+#include "pattern_library.h"
+
+static const size_t ACCESS_FIELD_SIDE = 2048;
+
+static size_t population;
+
+BENCHMARK(CellAccess) {
+  const GameField field(
+      GameField::createRandom(ACCESS_FIELD_SIDE, ACCESS_FIELD_SIDE, 0.3));
+  const std::string label = std::to_string(ACCESS_FIELD_SIDE) + "x" +
+                            std::to_string(ACCESS_FIELD_SIDE) + " ";
+
+  double seconds = measureBest(options.repeat, [&field]() {
+    population = 0;
+    for (int i = 0; i < field.getWidth(); i++)
+      for (int j = 0; j < field.getHeight(); j++)
+        population += field[i][j].isLife() ? 1 : 0;
+  });
+  reportResult("CellAccess", label + "proxies", seconds);
+
+  seconds = measureBest(options.repeat, [&field]() {
+    population = 0;
+    for (size_t i = 0; i < field.getWidth(); i++)
+      for (size_t j = 0; j < field.getHeight(); j++)
+        population += field.isLifeAt(i, j) ? 1 : 0;
+  });
+  reportResult("CellAccess", label + "interior", seconds);
+
+  seconds = measureBest(options.repeat, [&field]() {
+    population = 0;
+    for (size_t i = 0; i < field.getWidth(); i++) {
+      const uint64_t* row = field.getRow(i);
+      for (size_t word = 0; word < field.getRowWords(); word++)
+        population += countBits(row[word]);
+    }
+  });
+  reportResult("CellAccess", label + "raw rows", seconds);
+}
+
+static const size_t EDIT_FIELD_SIDE = 4096;
+
+BENCHMARK(RegionEdit) {
+  SilentViewHandler view;
+  GameManager game(EDIT_FIELD_SIDE, EDIT_FIELD_SIDE, view);
+  const std::string label = std::to_string(EDIT_FIELD_SIDE) + "x" +
+                            std::to_string(EDIT_FIELD_SIDE) + " ";
+  const size_t half = EDIT_FIELD_SIDE / 2;
+
+  double seconds = measureBest(options.repeat, [&game]() {
+    for (int i = 0; i < 100; i++)
+      game.setCellAt(i, i);
+  });
+  reportResult("RegionEdit", label + "set 100 cells", seconds);
+
+  seconds = measureBest(options.repeat, [&game, half]() {
+    game.fillRegion(1, 1, half, half, true);
+  });
+  reportResult("RegionEdit", label + "fill quarter", seconds);
+
+  seconds = measureBest(options.repeat, [&game, half]() {
+    game.randomizeRegion(0, 0, half, half, 0.3, 1);
+  });
+  reportResult("RegionEdit", label + "random quarter", seconds);
+
+  game.copyRegion(0, 0, half, half);
+  seconds = measureBest(options.repeat, [&game, half]() {
+    game.pasteRegion(half + 3, half + 3);
+  });
+  reportResult("RegionEdit", label + "paste quarter", seconds);
+
+  seconds = measureBest(options.repeat, [&game]() {
+    game.placePattern(
+        PatternLibrary::getInstance().find("gosper-gun")->getRotation(0), 7,
+        9);
+  });
+  reportResult("RegionEdit", label + "place gun", seconds);
+}
+
+BENCHMARK(RandomField) {
+  const double densities[] = {0.5, 0.3};
+  for (size_t side = 1024; side <= 8192; side *= 2)
+    for (double density : densities) {
+      const double seconds = measureBest(options.repeat, [side, density]() {
+        population += GameField::createRandom(side, side, density, 1)
+                          .getRow(0)[0];
+      });
+      reportResult("RandomField",
+                   std::to_string(side) + "x" + std::to_string(side) +
+                       " density " + std::to_string(density).substr(0, 3),
+                   seconds, side * side / 8);
+    }
+}
@@ -0,0 +1,44 @@
+//
+//  bench_batch.cpp
+//  GameOfLiveBenchmarks
+//
+
+#include <string>
+
+#include "benchmark.h"
+#include "field_batch.h"
+
+static const size_t BATCH_FIELDS = 1024;
+static const size_t BATCH_FIELD_SIDE = 32;
+static const size_t BATCH_GENERATIONS = 10;
+
+static std::vector<GameField> createFields() {
+  std::vector<GameField> fields;
+  for (size_t i = 0; i < BATCH_FIELDS; i++)
+    fields.push_back(GameField::createRandom(BATCH_FIELD_SIDE,
+                                             BATCH_FIELD_SIDE, 0.3, i));
+  return fields;
+}
+
+BENCHMARK(BatchStep) {
+  const std::string label = std::to_string(BATCH_FIELDS) + " fields " +
+                            std::to_string(BATCH_FIELD_SIDE) + "x" +
+                            std::to_string(BATCH_FIELD_SIDE);
+  const std::vector<GameField> fields(createFields());
+
+  double separate = measureBest(options.repeat, [&fields]() {
+    SilentViewHandler view;
+    for (const GameField& field : fields) {
+      GameManager game(field, view);
+      for (size_t i = 0; i < BATCH_GENERATIONS; i++)
+        game.nextStep();
+    }
+  });
+  reportResult("BatchStep", label + " separate", separate / BATCH_GENERATIONS);
+
+  double batched = measureBest(options.repeat, [&fields]() {
+    std::vector<GameField> batch(fields);
+    FieldBatch::stepAll(batch, BATCH_GENERATIONS);
+  });
+  reportResult("BatchStep", label + " batched", batched / BATCH_GENERATIONS);
+}
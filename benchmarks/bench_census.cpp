@@ -0,0 +1,24 @@
+//
+//  bench_census.cpp
+//  GameOfLiveBenchmarks
+//
+
+#include <string>
+
+#include "benchmark.h"
+#include "census.h"
+
+static const size_t CENSUS_FIELD_SIDES[] = {1024, 4096};
+
+BENCHMARK(TakeCensus) {
+  for (size_t side : CENSUS_FIELD_SIDES) {
+    const GameField field(GameField::createRandom(side, side, 0.05));
+
+    double seconds =
+        measureBest(options.repeat, [&field]() { takeCensus(field); });
+
+    const std::string label =
+        std::to_string(side) + "x" + std::to_string(side) + " 5% filled";
+    reportResult("TakeCensus", label, seconds);
+  }
+}
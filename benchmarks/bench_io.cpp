@@ -0,0 +1,178 @@
+//
+//  bench_io.cpp
+//  GameOfLiveBenchmarks
+//
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "benchmark.h"
+#include "pattern_library.h"
+#include "snapshot.h"
+
+static const char* BENCH_FILENAME = "bench_io.fld";
+
+// Density of sparse fields for snapshot benchmarks.
+static const double SPARSE_DENSITY = 0.01;
+
+/**
+ * @return Side of square field which text representation takes given number of
+ * bytes.
+ */
+static size_t getFieldSide(size_t bytes) {
+  return static_cast<size_t>(std::sqrt(static_cast<double>(bytes)));
+}
+
+static std::string getSizeLabel(size_t bytes) {
+  size_t side = getFieldSide(bytes);
+  return std::to_string(bytes / 1024 / 1024) + " MB (" + std::to_string(side) +
+         "x" + std::to_string(side) + ")";
+}
+
+static std::string fieldToString(const GameField& field) {
+  std::ostringstream out;
+  out << field;
+  return out.str();
+}
+
+/**
+ * @return Field in the RLE format with lines of up to 70 characters.
+ */
+static std::string fieldToRle(const GameField& field) {
+  std::ostringstream out;
+  out << "x = " << field.getHeight() << ", y = " << field.getWidth() << "\n";
+  size_t lineLength = 0;
+  auto put = [&](size_t run, char symbol) {
+    const std::string item = (run > 1 ? std::to_string(run) : "") + symbol;
+    if (lineLength + item.size() > 70) {
+      out << '\n';
+      lineLength = 0;
+    }
+    out << item;
+    lineLength += item.size();
+  };
+  for (size_t i = 0; i < field.getWidth(); i++) {
+    for (size_t j = 0; j < field.getHeight();) {
+      const bool alive = field.isLifeAt(i, j);
+      size_t run = 1;
+      while (j + run < field.getHeight() &&
+             field.isLifeAt(i, j + run) == alive)
+        run++;
+      put(run, alive ? 'o' : 'b');
+      j += run;
+    }
+    put(1, i + 1 == field.getWidth() ? '!' : '$');
+  }
+  return out.str();
+}
+
+static size_t getFileSize(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  return file.is_open() ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+BENCHMARK(ParseField) {
+  for (size_t bytes : options.getSizes()) {
+    size_t side = getFieldSide(bytes);
+    const std::string str(
+        fieldToString(GameField::createRandom(side, side, 0.3)));
+
+    double seconds =
+        measureBest(options.repeat, [&str]() { GameField field(str); });
+
+    reportResult("ParseField", getSizeLabel(bytes), seconds, str.size());
+  }
+}
+
+BENCHMARK(ParseRle) {
+  for (size_t bytes : options.getSizes()) {
+    size_t side = getFieldSide(bytes);
+    const std::string str(
+        fieldToRle(GameField::createRandom(side, side, 0.3)));
+
+    double seconds =
+        measureBest(options.repeat, [&str]() { parseRle(str); });
+
+    reportResult("ParseRle", getSizeLabel(bytes), seconds, str.size());
+  }
+}
+
+BENCHMARK(SerializeField) {
+  for (size_t bytes : options.getSizes()) {
+    size_t side = getFieldSide(bytes);
+    const GameField field(GameField::createRandom(side, side, 0.3));
+    size_t written = 0;
+
+    double seconds = measureBest(options.repeat, [&field, &written]() {
+      std::ostringstream out;
+      out << field;
+      written = static_cast<size_t>(out.tellp());
+    });
+
+    reportResult("SerializeField", getSizeLabel(bytes), seconds, written);
+  }
+}
+
+BENCHMARK(CommandSave) {
+  const std::string filename = options.workDir + "/" + BENCH_FILENAME;
+  for (size_t bytes : options.getSizes()) {
+    size_t side = getFieldSide(bytes);
+    SilentViewHandler view;
+    GameManager game(GameField::createRandom(side, side, 0.3), view);
+    std::ostringstream out;
+
+    double seconds = measureBest(options.repeat, [&game, &filename, &out]() {
+      game.executeCommand("save", {filename}, out);
+    });
+
+    reportResult("CommandSave", getSizeLabel(bytes), seconds,
+                 getFileSize(filename));
+  }
+  std::remove(filename.c_str());
+}
+
+BENCHMARK(CommandLoad) {
+  const std::string filename = options.workDir + "/" + BENCH_FILENAME;
+  for (size_t bytes : options.getSizes()) {
+    size_t side = getFieldSide(bytes);
+    SilentViewHandler view;
+    GameManager game(GameField::createRandom(side, side, 0.3), view);
+    std::ostringstream out;
+    game.executeCommand("save", {filename}, out);
+
+    double seconds = measureBest(options.repeat, [&game, &filename, &out]() {
+      game.executeCommand("load", {filename}, out);
+    });
+
+    reportResult("CommandLoad", getSizeLabel(bytes), seconds,
+                 getFileSize(filename));
+  }
+  std::remove(filename.c_str());
+}
+
+BENCHMARK(Snapshot) {
+  const double densities[] = {SPARSE_DENSITY, 0.3};
+  for (size_t bytes : options.getSizes())
+    for (double density : densities) {
+      size_t side = getFieldSide(bytes);
+      const GameField field(GameField::createRandom(side, side, density));
+      std::string snapshot;
+
+      double seconds = measureBest(options.repeat, [&field, &snapshot]() {
+        std::ostringstream out;
+        writeSnapshot(out, field);
+        snapshot = out.str();
+      });
+      const std::string label = getSizeLabel(bytes) + ", density " +
+                                std::to_string(density).substr(0, 4);
+      reportResult("SnapshotWrite", label, seconds, snapshot.size());
+
+      seconds = measureBest(options.repeat, [&snapshot]() {
+        std::istringstream in(snapshot);
+        readSnapshot(in);
+      });
+      reportResult("SnapshotRead", label, seconds, snapshot.size());
+    }
+}
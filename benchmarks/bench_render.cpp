@@ -0,0 +1,102 @@
+//
+//  bench_render.cpp
+//  GameOfLiveBenchmarks
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include "benchmark.h"
+#include "view_handler.h"
+
+// Size of the fake terminal, must fit largest field.
+static const char* RENDER_TERM_LINES = "300";
+static const char* RENDER_TERM_COLUMNS = "1000";
+
+// Number of rendered generations for each case.
+static const size_t RENDER_FRAMES = 50;
+
+struct RenderCase {
+  const char* label;
+  size_t width;
+  size_t height;
+  double density;
+};
+
+static const RenderCase RENDER_CASES[] = {
+    {"100x50 sparse", 100, 50, 0.02},
+    {"100x50 dense", 100, 50, 0.5},
+    {"400x250 sparse", 400, 250, 0.02},
+    {"400x250 dense", 400, 250, 0.5},
+};
+
+static size_t getWrittenBytes(FILE* file) {
+  std::fflush(file);
+  struct stat info;
+  if (fstat(fileno(file), &info) != 0)
+    return 0;
+  return static_cast<size_t>(info.st_size);
+}
+
+/**
+ * Generates sequence of generations, which will be rendered frame by frame.
+ */
+static std::vector<GameField> createGenerations(const RenderCase& render) {
+  SilentViewHandler silent;
+  GameManager game(
+      GameField::createRandom(render.width, render.height, render.density),
+      silent);
+  std::vector<GameField> generations;
+  for (size_t i = 0; i < RENDER_FRAMES; i++) {
+    generations.push_back(game.getCurrentField());
+    game.nextStep();
+  }
+  return generations;
+}
+
+BENCHMARK(RenderField) {
+  if (std::getenv("TERM") == nullptr)
+    setenv("TERM", "xterm", 1);
+  setenv("LINES", RENDER_TERM_LINES, 1);
+  setenv("COLUMNS", RENDER_TERM_COLUMNS, 1);
+
+  for (const RenderCase& render : RENDER_CASES) {
+    const std::vector<GameField> generations(createGenerations(render));
+
+    FILE* output = std::tmpfile();
+    FILE* input = std::fopen("/dev/null", "r");
+    if (output == nullptr || input == nullptr) {
+      std::cerr << "Cannot open fake terminal files." << std::endl;
+      return;
+    }
+
+    double seconds = 0;
+    size_t bytes = 0;
+    try {
+      CursesViewHandler view(output, input);
+
+      // First frame draws borders and prompts, it is not measured.
+      view.updateField(generations[0], 0);
+      size_t initialBytes = getWrittenBytes(output);
+
+      seconds = measureBest(1, [&view, &generations]() {
+        for (size_t i = 1; i < generations.size(); i++)
+          view.updateField(generations[i], i);
+      });
+      bytes = getWrittenBytes(output) - initialBytes;
+    } catch (const std::runtime_error& e) {
+      std::cerr << e.what() << std::endl;
+    }
+
+    std::fclose(input);
+    std::fclose(output);
+
+    size_t frames = generations.size() - 1;
+    const std::string label = std::string(render.label) + ", " +
+                              std::to_string(bytes / frames) + " B/frame";
+    reportResult("RenderField", label, seconds / frames);
+  }
+}
@@ -0,0 +1,56 @@
+//
+//  bench_step.cpp
+//  GameOfLiveBenchmarks
+//
+
+#include <string>
+
+#include "band_workers.h"
+#include "benchmark.h"
+
+// Number of generations for each field size.
+static const size_t STEP_GENERATIONS = 10;
+
+static const size_t STEP_FIELD_SIDES[] = {64, 256, 1024};
+
+// Side of the field, which is large enough to be stepped by bands.
+static const size_t BANDS_FIELD_SIDE = 8192;
+
+BENCHMARK(NextStep) {
+  for (size_t side : STEP_FIELD_SIDES) {
+    SilentViewHandler view;
+    GameManager game(GameField::createRandom(side, side, 0.3), view);
+
+    double seconds = measureBest(options.repeat, [&game]() {
+      for (size_t i = 0; i < STEP_GENERATIONS; i++)
+        game.nextStep();
+    });
+
+    const std::string label = std::to_string(side) + "x" +
+                              std::to_string(side) + " per generation";
+    reportResult("NextStep", label, seconds / STEP_GENERATIONS);
+  }
+}
+
+BENCHMARK(BandStep) {
+  BandWorkers& workers = BandWorkers::getInstance();
+  const size_t threads = workers.getThreads();
+  const size_t counts[] = {1, threads};
+  for (size_t count : counts) {
+    workers.setThreads(count);
+    SilentViewHandler view;
+    GameManager game(
+        GameField::createRandom(BANDS_FIELD_SIDE, BANDS_FIELD_SIDE, 0.3), view);
+
+    double seconds =
+        measureBest(options.repeat, [&game]() { game.nextStep(); });
+
+    const std::string label = std::to_string(BANDS_FIELD_SIDE) + "x" +
+                              std::to_string(BANDS_FIELD_SIDE) + ", " +
+                              std::to_string(count) + " thread(s)";
+    reportResult("BandStep", label, seconds);
+    if (threads == 1)
+      break;
+  }
+  workers.setThreads(threads);
+}
@@ -0,0 +1,81 @@
+//
+//  benchmark.cpp
+//  GameOfLiveBenchmarks
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#include "benchmark.h"
+
+static std::vector<std::pair<std::string, BenchmarkFunction>>& benchmarks() {
+  static std::vector<std::pair<std::string, BenchmarkFunction>> registered;
+  return registered;
+}
+
+bool registerBenchmark(const std::string& name, BenchmarkFunction function) {
+  benchmarks().push_back(std::make_pair(name, function));
+  return true;
+}
+
+std::vector<size_t> BenchmarkOptions::getSizes() const {
+  std::vector<size_t> sizes;
+  for (size_t mb = minMegabytes; mb <= maxMegabytes && mb != 0; mb *= 4)
+    sizes.push_back(mb * 1024 * 1024);
+  return sizes;
+}
+
+void reportResult(const std::string& benchmark,
+                  const std::string& label,
+                  double seconds,
+                  size_t bytes) {
+  std::printf("%-24s %-28s %12.3f ms", benchmark.c_str(), label.c_str(),
+              seconds * 1000);
+  if (bytes != 0)
+    std::printf(" %12.1f MB/s", bytes / 1048576.0 / seconds);
+  std::printf("\n");
+  std::fflush(stdout);
+}
+
+static void printUsage(const char* name) {
+  std::cerr << "Usage: " << name
+            << " [--min-mb N] [--max-mb N] [--repeat N] [--dir path]"
+               " [name filter...]"
+            << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+  BenchmarkOptions options;
+  std::vector<std::string> filters;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    bool hasValue = i + 1 < argc;
+    if (arg == "--min-mb" && hasValue)
+      options.minMegabytes = std::strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--max-mb" && hasValue)
+      options.maxMegabytes = std::strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--repeat" && hasValue)
+      options.repeat = std::strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--dir" && hasValue)
+      options.workDir = argv[++i];
+    else if (arg.compare(0, 2, "--") == 0) {
+      printUsage(argv[0]);
+      return 1;
+    } else
+      filters.push_back(arg);
+  }
+
+  for (auto benchmark : benchmarks()) {
+    bool selected = filters.empty();
+    for (auto filter : filters)
+      if (benchmark.first.find(filter) != std::string::npos)
+        selected = true;
+    if (selected)
+      benchmark.second(options);
+  }
+
+  return 0;
+}
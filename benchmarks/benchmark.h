@@ -0,0 +1,77 @@
+//
+//  benchmark.h
+//  GameOfLiveBenchmarks
+//
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game_handler.h"
+
+class BenchmarkOptions {
+ public:
+  // Smallest and largest input size in megabytes for size sweeps.
+  size_t minMegabytes = 1;
+  size_t maxMegabytes = 1024;
+
+  // Number of runs of each case, the best one is reported.
+  size_t repeat = 3;
+
+  // Directory for temporary files.
+  std::string workDir = ".";
+
+  /**
+   * @return Sizes in bytes from minMegabytes to maxMegabytes, each next is four
+   * times larger than previous.
+   */
+  std::vector<size_t> getSizes() const;
+};
+
+typedef void (*BenchmarkFunction)(const BenchmarkOptions&);
+
+/**
+ * Registers benchmark, use BENCHMARK macro instead.
+ */
+bool registerBenchmark(const std::string& name, BenchmarkFunction function);
+
+/**
+ * Prints one result line.
+ *
+ * @param bytes Number of processed bytes, if zero, only time is printed.
+ */
+void reportResult(const std::string& benchmark,
+                  const std::string& label,
+                  double seconds,
+                  size_t bytes = 0);
+
+/**
+ * Runs action several times.
+ *
+ * @return Best time in seconds.
+ */
+template <typename Action>
+double measureBest(size_t repeat, Action action) {
+  double best = 0;
+  for (size_t i = 0; i < repeat || i == 0; i++) {
+    auto start = std::chrono::steady_clock::now();
+    action();
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0 || time.count() < best)
+      best = time.count();
+  }
+  return best;
+}
+
+#define BENCHMARK(name)                                        \
+  static void name(const BenchmarkOptions& options);           \
+  static const bool name##Registered =                         \
+      registerBenchmark(#name, &name);                         \
+  static void name(const BenchmarkOptions& options)
+
+#endif /* BENCHMARK_H */
@@ -0,0 +1,309 @@
+//
+//  census.cpp
+//  GameOfLive
+//
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "census.h"
+
+typedef std::pair<size_t, size_t> CellPosition;
+
+// Well-known objects in the field text format.
+static const std::pair<const char*, const char*> KNOWN_OBJECTS[] = {
+    {"block", "##\n##"},
+    {"blinker", "###"},
+    {"beehive", ".##.\n#..#\n.##."},
+    {"loaf", ".##.\n#..#\n.#.#\n..#."},
+    {"boat", "##.\n#.#\n.#."},
+    {"ship", "##.\n#.#\n.##"},
+    {"tub", ".#.\n#.#\n.#."},
+    {"pond", ".##.\n#..#\n#..#\n.##."},
+    {"long boat", "##..\n#.#.\n.#.#\n..#."},
+    {"glider", ".#.\n..#\n###"},
+    {"glider", "#.#\n.##\n.#."},
+    {"toad", ".###\n###."},
+    {"beacon", "##..\n##..\n..##\n..##"},
+    {"beacon", "##..\n#...\n...#\n..##"},
+};
+
+/**
+ * Horizontal run of living cells in one row.
+ */
+class CellsRun {
+ public:
+  CellsRun(size_t row, size_t begin, size_t end)
+      : row(row), begin(begin), end(end) {}
+
+  size_t row;
+  size_t begin;
+  size_t end;  // Exclusive
+};
+
+/**
+ * Looks for the cell with given state in the packed row, skipping whole words.
+ *
+ * @return Position of the first such cell not before the given position or
+ * the row length, if there is no such cell.
+ */
+static size_t findCell(const uint64_t* row,
+                       size_t rowLength,
+                       size_t pos,
+                       bool life) {
+  const size_t words = (rowLength + 63) / 64;
+  size_t word = pos / 64;
+  if (word >= words)
+    return rowLength;
+
+  uint64_t bits = life ? row[word] : ~row[word];
+  bits &= ~uint64_t(0) << (pos % 64);
+  while (bits == 0) {
+    if (++word == words)
+      return rowLength;
+    bits = life ? row[word] : ~row[word];
+  }
+
+  size_t found = word * 64 + findFirstBit(bits);
+  return found < rowLength ? found : rowLength;
+}
+
+/**
+ * Disjoint sets of runs with path halving.
+ */
+class RunsUnion {
+ public:
+  RunsUnion(size_t size) : parents(size) {
+    for (size_t i = 0; i < size; i++)
+      parents[i] = i;
+  }
+
+  size_t find(size_t run) {
+    while (parents[run] != run) {
+      parents[run] = parents[parents[run]];
+      run = parents[run];
+    }
+    return run;
+  }
+
+  void unite(size_t first, size_t second) {
+    first = find(first);
+    second = find(second);
+    if (first < second)
+      parents[second] = first;
+    else if (second < first)
+      parents[first] = second;
+  }
+
+ private:
+  std::vector<size_t> parents;
+};
+
+/**
+ * Unites touching runs of two neighbour rows. Runs of each row are sorted.
+ *
+ * @param rowLength Length of rows for corners touching through the loop.
+ * @param rowLoop If ends of rows are neighbours.
+ */
+static void uniteRows(const std::vector<CellsRun>& runs,
+                      size_t first,
+                      size_t firstEnd,
+                      size_t second,
+                      size_t secondEnd,
+                      size_t rowLength,
+                      bool rowLoop,
+                      RunsUnion& unions) {
+  // Runs touch by sides or corners if they overlap with one cell margin
+  size_t i = first;
+  size_t j = second;
+  while (i < firstEnd && j < secondEnd) {
+    if (runs[i].begin <= runs[j].end && runs[j].begin <= runs[i].end)
+      unions.unite(i, j);
+    if (runs[i].end < runs[j].end)
+      i++;
+    else
+      j++;
+  }
+
+  // Corners through the loop
+  if (!rowLoop || first == firstEnd || second == secondEnd)
+    return;
+  const CellsRun& firstLast = runs[firstEnd - 1];
+  const CellsRun& secondLast = runs[secondEnd - 1];
+  if (firstLast.end == rowLength && runs[second].begin == 0)
+    unions.unite(firstEnd - 1, second);
+  if (secondLast.end == rowLength && runs[first].begin == 0)
+    unions.unite(secondEnd - 1, first);
+}
+
+/**
+ * Moves coordinates so that object crossing the field border becomes solid.
+ * The largest gap between occupied coordinates is considered as outside.
+ */
+static void unwrapCoordinates(std::vector<size_t>& coordinates,
+                              size_t module) {
+  std::vector<size_t> occupied(coordinates);
+  std::sort(occupied.begin(), occupied.end());
+  occupied.erase(std::unique(occupied.begin(), occupied.end()),
+                 occupied.end());
+
+  size_t start = occupied[0];
+  size_t maxGap = occupied[0] + module - occupied.back();
+  for (size_t i = 1; i < occupied.size(); i++)
+    if (occupied[i] - occupied[i - 1] > maxGap) {
+      maxGap = occupied[i] - occupied[i - 1];
+      start = occupied[i];
+    }
+
+  for (size_t& coordinate : coordinates)
+    coordinate = (coordinate + module - start) % module;
+}
+
+/**
+ * @return Object rows in the field text format separated with '/'.
+ */
+static std::string getObjectForm(std::vector<CellPosition>& cells) {
+  size_t minX = cells[0].first;
+  size_t minY = cells[0].second;
+  for (const CellPosition& cell : cells) {
+    minX = std::min(minX, cell.first);
+    minY = std::min(minY, cell.second);
+  }
+  size_t width = 0;
+  size_t height = 0;
+  for (CellPosition& cell : cells) {
+    cell.first -= minX;
+    cell.second -= minY;
+    width = std::max(width, cell.first + 1);
+    height = std::max(height, cell.second + 1);
+  }
+
+  std::string form(width * (height + 1) - 1, '.');
+  for (size_t i = 1; i < width; i++)
+    form[i * (height + 1) - 1] = '/';
+  for (const CellPosition& cell : cells)
+    form[cell.first * (height + 1) + cell.second] = '#';
+  return form;
+}
+
+/**
+ * @return The smallest form of the object under rotations and reflections.
+ */
+static std::string getCanonicalForm(const std::vector<CellPosition>& cells) {
+  std::string canonical;
+  for (int transform = 0; transform < 8; transform++) {
+    std::vector<CellPosition> transformed(cells);
+    for (CellPosition& cell : transformed) {
+      // Negation is done by subtraction from the large number, coordinates are
+      // normalized to zero later
+      size_t x = transform & 1 ? MAX_CENSUS_OBJECT_CELLS * 4 - cell.first
+                               : cell.first;
+      size_t y = transform & 2 ? MAX_CENSUS_OBJECT_CELLS * 4 - cell.second
+                               : cell.second;
+      cell = transform & 4 ? CellPosition(y, x) : CellPosition(x, y);
+    }
+    std::string form(getObjectForm(transformed));
+    if (canonical.empty() || form.size() < canonical.size() ||
+        (form.size() == canonical.size() && form < canonical))
+      canonical = form;
+  }
+  return canonical;
+}
+
+/**
+ * @return Names of well-known objects by their canonical forms.
+ */
+static std::map<std::string, std::string> createKnownObjects() {
+  std::map<std::string, std::string> known;
+  for (auto object : KNOWN_OBJECTS) {
+    const GameField field{std::string(object.second)};
+    std::vector<CellPosition> cells;
+    for (size_t i = 0; i < field.getWidth(); i++)
+      for (size_t j = 0; j < field.getHeight(); j++)
+        if (field.isLifeAt(i, j))
+          cells.push_back(CellPosition(i, j));
+    known[getCanonicalForm(cells)] = object.first;
+  }
+  return known;
+}
+
+static std::string getObjectName(const std::vector<CellPosition>& cells) {
+  if (cells.size() > MAX_CENSUS_OBJECT_CELLS)
+    return "large object";
+  const std::string canonical(getCanonicalForm(cells));
+  // Initialized once, also when census is taken from several threads
+  static const std::map<std::string, std::string> known(createKnownObjects());
+  auto name = known.find(canonical);
+  if (name != known.end())
+    return name->second;
+  return std::to_string(cells.size()) + " cells " + canonical;
+}
+
+std::map<std::string, size_t> takeCensus(const GameField& field) {
+  const size_t rows = field.getWidth();
+  const size_t rowLength = field.getHeight();
+  // Klein bottle flips the rows between the last and the first ones, objects
+  // crossing that edge are counted by parts
+  const bool rowsLoop = field.getBoundary() == BOUNDARY_TORUS;
+  const bool rowLoop = rowsLoop || field.getBoundary() == BOUNDARY_KLEIN;
+
+  // Runs of living cells, row by row
+  std::vector<CellsRun> runs;
+  std::vector<size_t> rowStarts(rows + 1);
+  for (size_t i = 0; i < rows; i++) {
+    rowStarts[i] = runs.size();
+    const uint64_t* row = field.getRow(i);
+    size_t begin = findCell(row, rowLength, 0, true);
+    while (begin < rowLength) {
+      size_t end = findCell(row, rowLength, begin, false);
+      runs.push_back(CellsRun(i, begin, end));
+      begin = findCell(row, rowLength, end, true);
+    }
+  }
+  rowStarts[rows] = runs.size();
+
+  RunsUnion unions(runs.size());
+  for (size_t i = 0; i < rows; i++) {
+    size_t begin = rowStarts[i];
+    size_t end = rowStarts[i + 1];
+    // Runs on both ends of the row touch through the loop
+    if (rowLoop && end - begin > 1 && runs[begin].begin == 0 &&
+        runs[end - 1].end == rowLength)
+      unions.unite(begin, end - 1);
+    size_t next = (i + 1) % rows;
+    if (next != i && (next != 0 || rowsLoop))
+      uniteRows(runs, begin, end, rowStarts[next], rowStarts[next + 1],
+                rowLength, rowLoop, unions);
+  }
+
+  // Cells of each object, mapped by the root run
+  std::map<size_t, std::vector<CellPosition>> objects;
+  for (size_t i = 0; i < runs.size(); i++) {
+    std::vector<CellPosition>& cells = objects[unions.find(i)];
+    if (cells.size() > MAX_CENSUS_OBJECT_CELLS)
+      continue;
+    for (size_t j = runs[i].begin; j < runs[i].end; j++)
+      cells.push_back(CellPosition(runs[i].row, j));
+  }
+
+  std::map<std::string, size_t> census;
+  for (auto& object : objects) {
+    std::vector<CellPosition>& cells = object.second;
+    if (cells.size() <= MAX_CENSUS_OBJECT_CELLS) {
+      std::vector<size_t> xs, ys;
+      for (const CellPosition& cell : cells) {
+        xs.push_back(cell.first);
+        ys.push_back(cell.second);
+      }
+      if (rowsLoop)
+        unwrapCoordinates(xs, rows);
+      if (rowLoop)
+        unwrapCoordinates(ys, rowLength);
+      for (size_t i = 0; i < cells.size(); i++)
+        cells[i] = CellPosition(xs[i], ys[i]);
+    }
+    census[getObjectName(cells)]++;
+  }
+  return census;
+}
@@ -0,0 +1,31 @@
+//
+//  census.h
+//  GameOfLive
+//
+
+#ifndef CENSUS_H
+#define CENSUS_H
+
+#include <map>
+#include <string>
+
+#include "game_field.h"
+
+// Objects with more cells are not canonicalized and counted together.
+const size_t MAX_CENSUS_OBJECT_CELLS = 1024;
+
+/**
+ * Extracts connected clusters of living cells (touching by sides or corners,
+ * through the field edges only if the boundary loops them) and counts
+ * occurrences of each object. Objects, which are
+ * equal under rotations and reflections, are counted together.
+ *
+ * Well-known objects are named ("block", "blinker", "glider"...), other are
+ * named by their cells count and canonical form, for example
+ * "8 cells #.#/###/#.#" (rows are separated with '/').
+ *
+ * @return Number of occurrences by object name.
+ */
+std::map<std::string, size_t> takeCensus(const GameField& field);
+
+#endif /* CENSUS_H */
@@ -0,0 +1,124 @@
+//
+//  field_batch.cpp
+//  GameOfLive
+//
+
+#include <stdexcept>
+
+#include "field_batch.h"
+
+/**
+ * Throws std::invalid_argument, if the field cannot be stepped in the batch
+ * of the given size.
+ */
+static void checkField(const GameField& field, size_t width, size_t height) {
+  if (field.getWidth() != width || field.getHeight() != height)
+    throw std::invalid_argument("Field size differs from batch size");
+  if (field.getBoundary() != BOUNDARY_TORUS)
+    throw std::invalid_argument("Batch supports only torus boundary");
+}
+
+FieldBatch::FieldBatch(size_t width, size_t height)
+    : width(width),
+      height(height),
+      cells(width * height),
+      nextCells(width * height),
+      previousX(width),
+      nextX(width),
+      previousY(height),
+      nextY(height) {
+  for (size_t i = 0; i < width; i++) {
+    previousX[i] = (i + width - 1) % width;
+    nextX[i] = (i + 1) % width;
+  }
+  for (size_t j = 0; j < height; j++) {
+    previousY[j] = (j + height - 1) % height;
+    nextY[j] = (j + 1) % height;
+  }
+}
+
+size_t FieldBatch::add(const GameField& field) {
+  if (lanes == BATCH_LANES)
+    throw std::invalid_argument("Batch is full");
+  checkField(field, width, height);
+
+  const uint64_t mask = uint64_t(1) << lanes;
+  for (size_t i = 0; i < width; i++)
+    for (size_t j = 0; j < height; j++)
+      if (field.isLifeAt(i, j))
+        cells[i * height + j] |= mask;
+  return lanes++;
+}
+
+GameField FieldBatch::get(size_t lane) const {
+  GameField field(width, height);
+  const uint64_t mask = uint64_t(1) << lane;
+  for (size_t i = 0; i < width; i++)
+    for (size_t j = 0; j < height; j++)
+      if (cells[i * height + j] & mask)
+        field.setLifeAt(i, j, true);
+  return field;
+}
+
+void FieldBatch::nextStep(size_t steps) {
+  for (size_t step = 0; step < steps; step++) {
+    for (size_t i = 0; i < width; i++) {
+      const uint64_t* above = &cells[previousX[i] * height];
+      const uint64_t* row = &cells[i * height];
+      const uint64_t* below = &cells[nextX[i] * height];
+      uint64_t* next = &nextCells[i * height];
+
+      for (size_t j = 0; j < height; j++) {
+        const size_t left = previousY[j];
+        const size_t right = nextY[j];
+        uint64_t ones = 0, twos = 0, fours = 0;
+        addNeighbour(above[left], ones, twos, fours);
+        addNeighbour(above[j], ones, twos, fours);
+        addNeighbour(above[right], ones, twos, fours);
+        addNeighbour(row[left], ones, twos, fours);
+        addNeighbour(row[right], ones, twos, fours);
+        addNeighbour(below[left], ones, twos, fours);
+        addNeighbour(below[j], ones, twos, fours);
+        addNeighbour(below[right], ones, twos, fours);
+
+        // Born with three neighbours, survives with two or three
+        next[j] = ~fours & twos & (ones | row[j]);
+      }
+    }
+    cells.swap(nextCells);
+  }
+}
+
+size_t FieldBatch::getSize() const {
+  return lanes;
+}
+
+size_t FieldBatch::getWidth() const {
+  return width;
+}
+
+size_t FieldBatch::getHeight() const {
+  return height;
+}
+
+void FieldBatch::stepAll(std::vector<GameField>& fields, size_t steps) {
+  if (fields.empty())
+    return;
+  const size_t width = fields[0].getWidth();
+  const size_t height = fields[0].getHeight();
+  // Nothing is stepped, if some field does not fit
+  for (const GameField& field : fields)
+    checkField(field, width, height);
+
+  for (size_t first = 0; first < fields.size(); first += BATCH_LANES) {
+    FieldBatch batch(width, height);
+    for (size_t i = first; i < fields.size() && batch.getSize() < BATCH_LANES;
+         i++)
+      batch.add(fields[i]);
+
+    batch.nextStep(steps);
+
+    for (size_t lane = 0; lane < batch.getSize(); lane++)
+      fields[first + lane] = batch.get(lane);
+  }
+}
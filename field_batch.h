@@ -0,0 +1,72 @@
+//
+//  field_batch.h
+//  GameOfLive
+//
+
+#ifndef FIELD_BATCH_H
+#define FIELD_BATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "game_field.h"
+
+// Number of fields, which are stepped together.
+const size_t BATCH_LANES = 64;
+
+/**
+ * Steps up to BATCH_LANES independent fields of the same size together.
+ * Cell of each position is stored in one word for all fields, each bit (lane)
+ * is a different field, so one bitwise operation processes all of them.
+ */
+class FieldBatch {
+ public:
+  FieldBatch(size_t width, size_t height);
+
+  /**
+   * Places copy of the field to the next free lane. Fields are always looped.
+   * Throws std::invalid_argument, if the batch is full, the field size
+   * differs from the batch one or the field boundary is not torus.
+   *
+   * @return Lane of the field.
+   */
+  size_t add(const GameField& field);
+
+  /**
+   * @return Field of the lane.
+   */
+  GameField get(size_t lane) const;
+
+  void nextStep(size_t steps = 1);
+
+  /**
+   * @return Number of used lanes.
+   */
+  size_t getSize() const;
+
+  size_t getWidth() const;
+
+  size_t getHeight() const;
+
+  /**
+   * Makes steps on each field of the same size, grouping them into batches.
+   * Throws std::invalid_argument before any step, if sizes of fields differ
+   * or some boundary is not torus.
+   */
+  static void stepAll(std::vector<GameField>& fields, size_t steps);
+
+ private:
+  size_t width;
+  size_t height;
+  size_t lanes = 0;
+
+  // Lanes of the cells, row by row
+  std::vector<uint64_t> cells;
+  std::vector<uint64_t> nextCells;
+
+  // Looped neighbour positions of each coordinate
+  std::vector<size_t> previousX, nextX;
+  std::vector<size_t> previousY, nextY;
+};
+
+#endif /* FIELD_BATCH_H */
@@ -0,0 +1,156 @@
+//
+//  field_pool.cpp
+//  GameOfLive
+//
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "band_workers.h"
+#include "field_pool.h"
+#include "profiler.h"
+
+// Set when the pool of the thread is destroyed, fields of static objects,
+// like the pattern library, are destroyed later and free buffers directly.
+static thread_local bool poolDestroyed = false;
+
+/**
+ * Free buffers of the thread, they are freed when the thread exits.
+ */
+struct FreeBuffers : std::vector<FieldBuffer> {
+  ~FreeBuffers() { poolDestroyed = true; }
+};
+
+static thread_local FreeBuffers freeBuffers;
+
+static std::atomic<int> hugePages(HUGE_PAGES_TRANSPARENT);
+
+/**
+ * @return Size of the mapping for the large buffer.
+ */
+static size_t getMappingSize(size_t bytes) {
+  return (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+}
+
+void* allocateFieldMemory(size_t bytes) {
+  if (bytes < HUGE_PAGE_BYTES)
+    return ::operator new(bytes);
+
+  const size_t size = getMappingSize(bytes);
+  void* memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (hugePages == HUGE_PAGES_RESERVED)
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (memory == MAP_FAILED) {
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+      throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    if (hugePages != HUGE_PAGES_NONE)
+      madvise(memory, size, MADV_HUGEPAGE);
+#endif
+  }
+  return memory;
+}
+
+void freeFieldMemory(void* memory, size_t bytes) {
+  if (bytes < HUGE_PAGE_BYTES)
+    ::operator delete(memory);
+  else
+    munmap(memory, getMappingSize(bytes));
+}
+
+/**
+ * Fills the buffer with zeros or copies the source by bands.
+ *
+ * @param from Source buffer of the same size or nullptr for zeros.
+ */
+static void fillInBands(FieldBuffer& buffer, const FieldBuffer* from) {
+  uint64_t* to = buffer.data();
+  const uint64_t* source = from ? from->data() : nullptr;
+  runInBands(buffer.size(), 1, buffer.size(),
+             [=](size_t band, size_t begin, size_t end) {
+               if (source)
+                 std::copy(source + begin, source + end, to + begin);
+               else
+                 std::fill(to + begin, to + end, 0);
+             });
+}
+
+FieldBuffer FieldBufferPool::take(size_t words) {
+  if (poolDestroyed)
+    return FieldBuffer();
+  size_t best = freeBuffers.size();
+  for (size_t i = 0; i < freeBuffers.size(); i++)
+    if (freeBuffers[i].capacity() >= words &&
+        freeBuffers[i].capacity() / 2 <= words &&
+        (best == freeBuffers.size() ||
+         freeBuffers[i].capacity() < freeBuffers[best].capacity()))
+      best = i;
+
+  FieldBuffer buffer;
+  if (best == freeBuffers.size()) {
+    PROFILE_COUNT(COUNTER_BUFFERS_ALLOCATED, 1);
+    return buffer;
+  }
+  PROFILE_COUNT(COUNTER_BUFFERS_REUSED, 1);
+  buffer.swap(freeBuffers[best]);
+  freeBuffers.erase(freeBuffers.begin() + best);
+  return buffer;
+}
+
+FieldBuffer FieldBufferPool::acquire(size_t words) {
+  FieldBuffer buffer(take(words));
+  buffer.resize(words);
+  fillInBands(buffer, nullptr);
+  return buffer;
+}
+
+FieldBuffer FieldBufferPool::acquireCopy(const FieldBuffer& from) {
+  FieldBuffer buffer(take(from.size()));
+  buffer.resize(from.size());
+  fillInBands(buffer, &from);
+  return buffer;
+}
+
+void FieldBufferPool::assign(FieldBuffer& to, const FieldBuffer& from) {
+  if (to.capacity() < from.size()) {
+    release(to);
+    to = take(from.size());
+  }
+  to.resize(from.size());
+  fillInBands(to, &from);
+}
+
+void FieldBufferPool::release(FieldBuffer& buffer) {
+  if (buffer.capacity() == 0)
+    return;
+  if (!poolDestroyed && freeBuffers.size() < MAX_POOLED_BUFFERS) {
+    buffer.clear();
+    freeBuffers.push_back(FieldBuffer());
+    freeBuffers.back().swap(buffer);
+  } else
+    FieldBuffer().swap(buffer);
+}
+
+void FieldBufferPool::clear() {
+  if (!poolDestroyed)
+    freeBuffers.clear();
+}
+
+size_t FieldBufferPool::getFreeCount() {
+  return poolDestroyed ? 0 : freeBuffers.size();
+}
+
+HugePages FieldBufferPool::getHugePages() {
+  return static_cast<HugePages>(hugePages.load());
+}
+
+void FieldBufferPool::setHugePages(HugePages pages) {
+  hugePages = pages;
+}
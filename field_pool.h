@@ -0,0 +1,139 @@
+//
+//  field_pool.h
+//  GameOfLive
+//
+
+#ifndef FIELD_POOL_H
+#define FIELD_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Number of free buffers kept for reuse by each thread.
+const size_t MAX_POOLED_BUFFERS = 4;
+
+// Buffers of this size and larger are mapped separately with huge pages.
+const size_t HUGE_PAGE_BYTES = 2 << 20;
+
+enum HugePages {
+  HUGE_PAGES_NONE,         // Regular pages only
+  HUGE_PAGES_TRANSPARENT,  // Transparent huge pages are advised
+  HUGE_PAGES_RESERVED      // Reserved huge pages, transparent if none left
+};
+
+/**
+ * Allocates memory for the field buffer, large buffers are mapped with huge
+ * pages. Throws std::bad_alloc, if there is no memory.
+ */
+void* allocateFieldMemory(size_t bytes);
+
+void freeFieldMemory(void* memory, size_t bytes);
+
+/**
+ * Allocator of field buffers. Elements are left uninitialized on resize, so
+ * memory is first touched by the thread, which fills it.
+ */
+template <typename T>
+class FieldAllocator {
+ public:
+  typedef T value_type;
+
+  FieldAllocator() = default;
+
+  template <typename U>
+  FieldAllocator(const FieldAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(allocateFieldMemory(count * sizeof(T)));
+  }
+
+  void deallocate(T* memory, size_t count) {
+    freeFieldMemory(memory, count * sizeof(T));
+  }
+
+  template <typename U>
+  void construct(U* place) {
+    ::new (static_cast<void*>(place)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* place, Args&&... args) {
+    ::new (static_cast<void*>(place)) U(std::forward<Args>(args)...);
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const FieldAllocator<T>&, const FieldAllocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const FieldAllocator<T>&, const FieldAllocator<U>&) {
+  return false;
+}
+
+typedef std::vector<uint64_t, FieldAllocator<uint64_t>> FieldBuffer;
+
+/**
+ * Recycles cell buffers of fields, so resets, undo snapshots and batch jobs
+ * do not allocate and fault in new memory for each field of the same size.
+ * Each thread has its own pool, so no locking is needed.
+ *
+ * Large buffers are filled by band threads, the same bands are stepped by the
+ * same threads, so memory of each band is local to its thread.
+ */
+class FieldBufferPool {
+ public:
+  /**
+   * @return Buffer of the given size filled with zeros, the free buffer of
+   * close capacity is reused, if there is one.
+   */
+  static FieldBuffer acquire(size_t words);
+
+  /**
+   * @return Copy of the buffer in the reused memory, if possible.
+   */
+  static FieldBuffer acquireCopy(const FieldBuffer& from);
+
+  /**
+   * Copies the buffer reusing memory of the destination.
+   */
+  static void assign(FieldBuffer& to, const FieldBuffer& from);
+
+  /**
+   * Takes memory of the buffer for reuse, the buffer becomes empty.
+   * If the pool is full, memory is freed.
+   */
+  static void release(FieldBuffer& buffer);
+
+  /**
+   * Frees all buffers of the current thread pool.
+   */
+  static void clear();
+
+  /**
+   * @return Number of free buffers in the current thread pool.
+   */
+  static size_t getFreeCount();
+
+  static HugePages getHugePages();
+
+  /**
+   * Sets kind of pages for new large buffers.
+   */
+  static void setHugePages(HugePages pages);
+
+ private:
+  /**
+   * Takes the smallest free buffer with at least the given capacity, buffers
+   * more than twice larger are not taken to not hold their memory.
+   *
+   * @return Empty buffer, possibly without allocated memory.
+   */
+  static FieldBuffer take(size_t words);
+};
+
+#endif /* FIELD_POOL_H */
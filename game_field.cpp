@@ -6,13 +6,25 @@
 //  Copyright © 2017 Кирилл. All rights reserved.
 //
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <numeric>
 #include <sstream>
 
+#include "band_workers.h"
 #include "game_field.h"
 
 const char ALIVE_CELL = '#';
 const char NO_CELL = '.';
 
+// Number of binary digits of the density of random fields.
+static const size_t DENSITY_BITS = 16;
+
+// Size of the buffer of formatted rows written at once.
+static const size_t WRITE_BUFFER_SIZE = 1 << 20;
+
 /**
  * Makes the position looped in.
  * The neighbors of the upper cells are lower,
@@ -25,10 +37,20 @@ const char NO_CELL = '.';
  */
 static int loopCoordinate(int pos, size_t module) {
   if (pos < 0)
-    return (static_cast<int>(module)) - (-pos) % module;
+    return (module - (-pos) % module) % module;
   return pos % module;
 }
 
+/**
+ * SplitMix64 random number of the sequence, numbers do not depend on the
+ * previous ones, so any part of the sequence is generated independently.
+ *
+ * @param index Position of the number in the sequence of the seed.
+ */
+static uint64_t getRandom(uint64_t seed, uint64_t index) {
+  return mix64(seed + (index + 1) * GOLDEN_GAMMA);
+}
+
 BadGameFieldException::BadGameFieldException(size_t line,
                                              size_t pos,
                                              const std::string& reason) {
@@ -41,39 +63,151 @@ const char* BadGameFieldException::what() const noexcept {
   return reason.c_str();
 }
 
+/**
+ * @return Number of 64-bit words for the row of cells.
+ */
+static size_t getWordsCount(size_t cells) {
+  return (cells + 63) / 64;
+}
+
 GameField::GameField(size_t width, size_t height)
-    : width(width), height(height) {
-  field = std::vector<std::vector<bool>>(width);
-  for (size_t i = 0; i < width; i++)
-    field[i] = std::vector<bool>(height);
+    : width(width),
+      height(height),
+      rowWords(getWordsCount(height)),
+      rowStride(rowWords + 2),
+      cells(FieldBufferPool::acquire((width + 2) * rowStride)) {}
+
+/**
+ * @return Beginning of the first line, which starts not before the position.
+ */
+static size_t findLineStart(const std::string& str, size_t pos) {
+  if (pos == 0 || pos >= str.size())
+    return std::min(pos, str.size());
+  size_t newline = str.find('\n', pos - 1);
+  return newline == std::string::npos ? str.size() : newline + 1;
 }
 
 GameField::GameField(const std::string& str) {
-  field.push_back(std::vector<bool>());
-  size_t line = 0;
+  // Width of the first line defines size of rows
   size_t maxWidth = 0;
+  for (size_t i = 0; i < str.size() && str[i] != '\n'; i++)
+    if (str[i] != '\r')
+      maxWidth++;
+  height = maxWidth;
+  rowWords = getWordsCount(maxWidth);
+  rowStride = rowWords + 2;
+
+  // String is split into chunks of whole lines, lines are counted to find the
+  // first row of each chunk
+  const size_t threads = BandWorkers::getInstance().getThreads();
+  const size_t textWords = str.size() / sizeof(uint64_t);
+  std::vector<size_t> chunkLines(threads + 1, 0);
+  runInBands(str.size(), 1, textWords,
+             [&](size_t chunk, size_t begin, size_t end) {
+               chunkLines[chunk + 1] =
+                   std::count(str.begin() + findLineStart(str, begin),
+                              str.begin() + findLineStart(str, end), '\n');
+             });
+  std::partial_sum(chunkLines.begin(), chunkLines.end(), chunkLines.begin());
+
+  size_t line = chunkLines.back();
+  size_t lastLineStart = str.rfind('\n');
+  lastLineStart = lastLineStart == std::string::npos ? 0 : lastLineStart + 1;
+  const size_t currWidth =
+      str.size() - lastLineStart -
+      std::count(str.begin() + lastLineStart, str.end(), '\r');
+  // Count the last line, if it is not empty, empty lines are not rows
+  if (maxWidth != 0 && currWidth != 0)
+    line++;
+  else if (maxWidth == 0 && line != 0)
+    line--;
+  width = line;
+  cells = FieldBufferPool::acquire((width + 2) * rowStride);
+
+  // Chunks are parsed into their rows in parallel, the first error in the
+  // string order is reported
+  std::vector<std::exception_ptr> errors(threads);
+  runInBands(str.size(), 1, textWords,
+             [&](size_t chunk, size_t begin, size_t end) {
+               try {
+                 parseLines(str, findLineStart(str, begin),
+                            findLineStart(str, end), chunkLines[chunk]);
+               } catch (const BadGameFieldException&) {
+                 errors[chunk] = std::current_exception();
+               }
+             });
+  for (const std::exception_ptr& error : errors)
+    if (error)
+      std::rethrow_exception(error);
+  if (maxWidth != currWidth && currWidth != 0)
+    throw BadGameFieldException(chunkLines.back(), currWidth,
+                                "Invalid number of characters in the line");
+}
+
+/**
+ * Packs the line of exactly row length into the row.
+ *
+ * @return false, if the line has other characters than cells, the row may be
+ * partially filled then.
+ */
+static bool packLine(const char* text, size_t length, uint64_t* row) {
+  bool valid = true;
+  for (size_t word = 0; word * 64 < length; word++) {
+    const size_t cells = std::min<size_t>(64, length - word * 64);
+    const char* chars = text + word * 64;
+    uint64_t bits = 0;
+    for (size_t bit = 0; bit < cells; bit++) {
+      bits |= uint64_t(chars[bit] == ALIVE_CELL) << bit;
+      valid &= chars[bit] == ALIVE_CELL || chars[bit] == NO_CELL;
+    }
+    row[word] = bits;
+  }
+  return valid;
+}
+
+void GameField::parseLines(const std::string& str,
+                           size_t begin,
+                           size_t end,
+                           size_t line) {
+  for (size_t pos = begin; pos < end; line++) {
+    const char* text = str.data() + pos;
+    const char* newline =
+        static_cast<const char*>(std::memchr(text, '\n', end - pos));
+    const size_t length = newline ? newline - text : end - pos;
+    const size_t next = newline ? pos + length + 1 : end;
+    // Lines of other length or with other characters are parsed by cells to
+    // report the exact error
+    if (length != height || !packLine(text, length, getRow(line))) {
+      if (length == height)
+        std::fill(getRow(line), getRow(line) + rowWords, 0);
+      parseCells(str, pos, next, line);
+    }
+    pos = next;
+  }
+}
+
+void GameField::parseCells(const std::string& str,
+                           size_t begin,
+                           size_t end,
+                           size_t line) {
   size_t currWidth = 0;
-  for (size_t i = 0; i < str.size(); i++) {
+  for (size_t i = begin; i < end; i++) {
     switch (str[i]) {
       case '\n':
-        if (maxWidth != currWidth)
+        if (height != currWidth)
           throw BadGameFieldException(
               line, currWidth, "Invalid number of characters in the line");
         line++;
         currWidth = 0;
-        field.push_back(std::vector<bool>());
         break;
       case ALIVE_CELL:
-        if (line == 0)
-          maxWidth++;
+        // Longer lines are reported at their end
+        if (currWidth < height)
+          getRow(line)[currWidth / 64] |= uint64_t(1) << (currWidth % 64);
         currWidth++;
-        field[line].push_back(true);
         break;
       case NO_CELL:
-        if (line == 0)
-          maxWidth++;
         currWidth++;
-        field[line].push_back(false);
         break;
       case '\r':
         continue;
@@ -82,18 +216,50 @@ GameField::GameField(const std::string& str) {
             line, currWidth, std::string("Unknown character '") + str[i] + "'");
     }
   }
-  if (maxWidth != currWidth && currWidth != 0)
-    throw BadGameFieldException(line, currWidth,
-                                "Invalid number of characters in the line");
-  if (maxWidth != 0)
-    line++;
-  if (currWidth == 0 && line != 0) {
-    field.pop_back();
-    line--;
-  }
+}
 
-  width = line;
-  height = maxWidth;
+GameField GameField::createRandom(size_t width,
+                                  size_t height,
+                                  double density,
+                                  uint64_t seed) {
+  GameField field(width, height);
+  // Comparison is false for NaN, so it is clamped to zero as well
+  const double clamped = density > 0 ? std::min(density, 1.0) : 0;
+  const uint64_t digits =
+      static_cast<uint64_t>(clamped * (1 << DENSITY_BITS) + 0.5);
+  if (digits == 0 || field.rowWords == 0)
+    return field;
+
+  // Each digit of the density from the lowest set one mixes the next random
+  // word into the cells: by OR if the digit is set, otherwise by AND, so each
+  // cell is alive with the probability of the density
+  const size_t lowestDigit = findFirstBit(digits);
+  const size_t rounds = DENSITY_BITS - lowestDigit;
+  // Density 1 has no digits after the point
+  const uint64_t fullCells = digits >> DENSITY_BITS ? ~uint64_t(0) : 0;
+  const size_t words = field.rowWords;
+  const uint64_t lastWordMask =
+      height % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (height % 64)) - 1;
+  // Random numbers are indexed by cell words, so bands of rows are generated
+  // in parallel and the field depends only on the seed
+  runInBands(width, 1, width * field.rowStride,
+             [&](size_t, size_t begin, size_t end) {
+               for (size_t i = begin; i < end; i++) {
+                 uint64_t* row = field.getRow(i);
+                 for (size_t k = 0; k < words; k++) {
+                   const uint64_t index = (i * words + k) * rounds;
+                   uint64_t cells = fullCells;
+                   for (size_t round = 0; round < rounds; round++) {
+                     const uint64_t random = getRandom(seed, index + round);
+                     cells = (digits >> (lowestDigit + round)) & 1
+                                 ? cells | random
+                                 : cells & random;
+                   }
+                   row[k] = k + 1 == words ? cells & lastWordMask : cells;
+                 }
+               }
+             });
+  return field;
 }
 
 GameField::SubGameField GameField::operator[](int pos) {
@@ -113,40 +279,188 @@ size_t GameField::getHeight() const {
   return height;
 }
 
+size_t GameField::getMemoryUsage() const {
+  return sizeof(GameField) + cells.capacity() * sizeof(uint64_t);
+}
+
+/**
+ * Sets ghost cells before and after the packed row: cells of the other end of
+ * the row for loop or the edge cells themselves for mirror.
+ */
+template <FieldBoundary Boundary>
+static void setRowGhosts(uint64_t* row, size_t height) {
+  const bool mirror = Boundary == BOUNDARY_MIRROR;
+  row[-1] = getRowCell(row, mirror ? 0 : height - 1) ? uint64_t(1) << 63 : 0;
+  // Ghost cell after the row is at the position of the cell Y = height
+  if (getRowCell(row, mirror ? height - 1 : 0))
+    row[height / 64] |= uint64_t(1) << (height % 64);
+}
+
+/**
+ * Writes cells of the packed row in the reversed order without ghost cells.
+ */
+static void reverseRow(const uint64_t* from, uint64_t* to, size_t height) {
+  std::fill(to, to + getWordsCount(height), 0);
+  for (size_t j = 0; j < height; j++)
+    if (getRowCell(from, j)) {
+      const size_t pos = height - 1 - j;
+      to[pos / 64] |= uint64_t(1) << (pos % 64);
+    }
+}
+
+template <FieldBoundary Boundary>
+void GameField::refreshGhosts() {
+  if (Boundary == BOUNDARY_DEAD)
+    return;
+  for (size_t i = 0; i < width; i++)
+    setRowGhosts<Boundary>(getRow(i), height);
+
+  uint64_t* above = getRow(0) - rowStride;
+  uint64_t* below = getRow(width - 1) + rowStride;
+  if (Boundary == BOUNDARY_KLEIN) {
+    // Flipped rows are looped along the row like torus ones
+    reverseRow(getRow(width - 1), above, height);
+    reverseRow(getRow(0), below, height);
+    setRowGhosts<BOUNDARY_TORUS>(above, height);
+    setRowGhosts<BOUNDARY_TORUS>(below, height);
+    return;
+  }
+  // Rows are copied with their ghost cells, so corners follow the boundary
+  const bool torus = Boundary == BOUNDARY_TORUS;
+  const uint64_t* fromAbove = getRow(torus ? width - 1 : 0) - 1;
+  const uint64_t* fromBelow = getRow(torus ? 0 : width - 1) - 1;
+  std::copy(fromAbove, fromAbove + rowStride, above - 1);
+  std::copy(fromBelow, fromBelow + rowStride, below - 1);
+}
+
+void GameField::refreshGhosts() {
+  if (width == 0 || height == 0)
+    return;
+  // Boundary is chosen once, each rule is compiled separately
+  switch (boundary) {
+    case BOUNDARY_TORUS:
+      refreshGhosts<BOUNDARY_TORUS>();
+      break;
+    case BOUNDARY_DEAD:
+      refreshGhosts<BOUNDARY_DEAD>();
+      break;
+    case BOUNDARY_MIRROR:
+      refreshGhosts<BOUNDARY_MIRROR>();
+      break;
+    case BOUNDARY_KLEIN:
+      refreshGhosts<BOUNDARY_KLEIN>();
+      break;
+  }
+}
+
+void GameField::clearGhosts() {
+  if (width == 0 || height == 0)
+    return;
+  const size_t rightWord = height / 64;
+  const uint64_t rightMask = uint64_t(1) << (height % 64);
+  for (size_t i = 0; i < width; i++) {
+    uint64_t* row = getRow(i);
+    row[-1] = 0;
+    row[rightWord] &= ~rightMask;
+  }
+  std::fill(cells.begin(), cells.begin() + rowStride, 0);
+  std::fill(cells.end() - rowStride, cells.end(), 0);
+}
+
 GameField& GameField::operator=(const GameField& copy) {
   if (&copy != this) {
     width = copy.width;
     height = copy.height;
-    field = copy.field;
+    rowWords = copy.rowWords;
+    rowStride = copy.rowStride;
+    boundary = copy.boundary;
+    FieldBufferPool::assign(cells, copy.cells);
+  }
+  return (*this);
+}
+
+GameField& GameField::operator=(GameField&& toMove) noexcept {
+  if (&toMove != this) {
+    FieldBufferPool::release(cells);
+    width = toMove.width;
+    height = toMove.height;
+    rowWords = toMove.rowWords;
+    rowStride = toMove.rowStride;
+    boundary = toMove.boundary;
+    cells.swap(toMove.cells);
+    toMove.width = toMove.height = toMove.rowWords = 0;
   }
   return (*this);
 }
 
+void GameField::swap(GameField& other) noexcept {
+  std::swap(width, other.width);
+  std::swap(height, other.height);
+  std::swap(rowWords, other.rowWords);
+  std::swap(rowStride, other.rowStride);
+  std::swap(boundary, other.boundary);
+  cells.swap(other.cells);
+}
+
 bool GameField::operator==(const GameField& equal) const {
-  return field == equal.field;
+  return width == equal.width && height == equal.height &&
+         cells == equal.cells;
+}
+
+/**
+ * @return Characters of eight cells for each byte of the packed row.
+ */
+static std::vector<std::array<char, 8>> createByteCells() {
+  std::vector<std::array<char, 8>> cells(256);
+  for (size_t byte = 0; byte < cells.size(); byte++)
+    for (size_t bit = 0; bit < 8; bit++)
+      cells[byte][bit] = (byte >> bit) & 1 ? ALIVE_CELL : NO_CELL;
+  return cells;
 }
 
 std::ostream& operator<<(std::ostream& stream, const GameField& field) {
-  for (int i = 0; i < field.width; i++) {
-    for (int j = 0; j < field.height; j++)
-      stream << (field.field[i][j] ? ALIVE_CELL : NO_CELL);
-    if (i != field.width - 1)
-      stream << std::endl;
+  static const std::vector<std::array<char, 8>> byteCells(createByteCells());
+  const size_t height = field.getHeight();
+  const size_t wholeBytes = height / 8;
+
+  // Rows are formatted by whole bytes of cells into the buffer, which is
+  // written by large blocks, small fields take only their own size
+  const size_t fieldSize = field.getWidth() * (height + 1);
+  std::vector<char> buffer(
+      std::max(std::min(WRITE_BUFFER_SIZE, fieldSize), height + 1));
+  size_t used = 0;
+  for (size_t i = 0; i < field.getWidth(); i++) {
+    if (used + height + 1 > buffer.size()) {
+      stream.write(buffer.data(), used);
+      used = 0;
+    }
+    const uint64_t* row = field.getRow(i);
+    char* out = buffer.data() + used;
+    for (size_t byte = 0; byte < wholeBytes; byte++, out += 8) {
+      const uint8_t cells = row[byte / 8] >> (byte % 8 * 8);
+      std::memcpy(out, byteCells[cells].data(), 8);
+    }
+    for (size_t j = wholeBytes * 8; j < height; j++)
+      *out++ = field.isLifeAt(i, j) ? ALIVE_CELL : NO_CELL;
+    if (i != field.getWidth() - 1)
+      *out++ = '\n';
+    used = out - buffer.data();
   }
+  stream.write(buffer.data(), used);
   return stream;
 }
 
 GameField::SubGameField::Cell GameField::SubGameField::operator[](int pos) {
-  return Cell(posX, loopCoordinate(pos, height), field);
+  return Cell(posX, loopCoordinate(pos, game.height), game);
 }
 
 const GameField::SubGameField::Cell GameField::SubGameField::operator[](
     int pos) const {
-  return Cell(posX, loopCoordinate(pos, height), field);
+  return Cell(posX, loopCoordinate(pos, game.height), game);
 }
 
 bool GameField::SubGameField::Cell::isLife() const {
-  return field[posX][posY];
+  return game.isLifeAt(posX, posY);
 }
 
 size_t GameField::SubGameField::Cell::getX() const {
@@ -158,9 +472,9 @@ size_t GameField::SubGameField::Cell::getY() const {
 }
 
 void GameField::SubGameField::Cell::bornLife() {
-  field[posX][posY] = true;
+  game.setLifeAt(posX, posY, true);
 }
 
 void GameField::SubGameField::Cell::kill() {
-  field[posX][posY] = false;
+  game.setLifeAt(posX, posY, false);
 }
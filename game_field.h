@@ -9,10 +9,72 @@
 #ifndef GAME_FIELD_H
 #define GAME_FIELD_H
 
+#include <cstdint>
 #include <exception>
 #include <ostream>
+#include <utility>
 #include <vector>
 
+#include "field_pool.h"
+
+/**
+ * @return Number of set bits in the word.
+ */
+inline size_t countBits(uint64_t word) {
+  return __builtin_popcountll(word);
+}
+
+/**
+ * @return Index of the lowest set bit, word must not be zero.
+ */
+inline size_t findFirstBit(uint64_t word) {
+  return __builtin_ctzll(word);
+}
+
+// Increment of the SplitMix64 sequence, the golden ratio.
+const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * SplitMix64 mixing of the word, close words give unrelated results. Used for
+ * random cells, soup seeds and cell hashes.
+ */
+inline uint64_t mix64(uint64_t word) {
+  word = (word ^ (word >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  word = (word ^ (word >> 27)) * 0x94D049BB133111EBULL;
+  return word ^ (word >> 31);
+}
+
+/**
+ * @return Cell of the packed row.
+ */
+inline bool getRowCell(const uint64_t* row, size_t pos) {
+  return (row[pos / 64] >> (pos % 64)) & 1;
+}
+
+/**
+ * Adds neighbour bits to the bit-sliced counters, each bit position is counted
+ * separately. Counter "fours" is saturated, it means four or more neighbours.
+ */
+inline void addNeighbour(uint64_t neighbour,
+                         uint64_t& ones,
+                         uint64_t& twos,
+                         uint64_t& fours) {
+  uint64_t carry = ones & neighbour;
+  ones ^= neighbour;
+  fours |= twos & carry;
+  twos ^= carry;
+}
+
+/**
+ * Rule for neighbours of the cells on the field edges.
+ */
+enum FieldBoundary {
+  BOUNDARY_TORUS,   // Opposite edges are neighbours
+  BOUNDARY_DEAD,    // Cells outside the field are always dead
+  BOUNDARY_MIRROR,  // Cells outside the field repeat the nearest edge cells
+  BOUNDARY_KLEIN    // Like torus, but the first and the last rows are flipped
+};
+
 class BadGameFieldException : public std::exception {
  public:
   BadGameFieldException(size_t line, size_t pos, const std::string& reason);
@@ -30,7 +92,27 @@ class GameField {
   GameField(size_t width, size_t height);
 
   GameField(const GameField& toCopy)
-      : width(toCopy.width), height(toCopy.height), field(toCopy.field) {}
+      : width(toCopy.width),
+        height(toCopy.height),
+        rowWords(toCopy.rowWords),
+        rowStride(toCopy.rowStride),
+        boundary(toCopy.boundary),
+        cells(FieldBufferPool::acquireCopy(toCopy.cells)) {}
+
+  /**
+   * Takes cells of the field without copying, moved field becomes empty.
+   */
+  GameField(GameField&& toMove) noexcept
+      : width(toMove.width),
+        height(toMove.height),
+        rowWords(toMove.rowWords),
+        rowStride(toMove.rowStride),
+        boundary(toMove.boundary),
+        cells(std::move(toMove.cells)) {
+    toMove.width = toMove.height = toMove.rowWords = 0;
+  }
+
+  ~GameField() { FieldBufferPool::release(cells); }
 
   /**
    * Parse string and creates field from it.
@@ -41,6 +123,17 @@ class GameField {
    */
   GameField(const std::string& str);
 
+  /**
+   * Creates field with randomly placed cells.
+   *
+   * @param density Probability of life in each cell.
+   * @param seed Random generator seed, the same seed gives the same field.
+   */
+  static GameField createRandom(size_t width,
+                                size_t height,
+                                double density,
+                                uint64_t seed = 0);
+
   SubGameField operator[](int pos);
 
   const SubGameField operator[](int pos) const;
@@ -49,19 +142,128 @@ class GameField {
 
   size_t getHeight() const;
 
+  /**
+   * Boundary rule used by steps, new fields are looped in both directions.
+   * Cell proxies loop the coordinates with any boundary.
+   */
+  FieldBoundary getBoundary() const { return boundary; }
+
+  void setBoundary(FieldBoundary boundary) { this->boundary = boundary; }
+
+  /**
+   * @return Number of 64-bit words in each row.
+   */
+  size_t getRowWords() const { return rowWords; }
+
+  /**
+   * @return Distance in words between beginnings of neighbour rows.
+   */
+  size_t getRowStride() const { return rowStride; }
+
+  /**
+   * Packed cells of the row without looping, cell Y is bit (Y % 64) of word
+   * (Y / 64). Bits after the last cell of the row are always zero.
+   *
+   * Rows are surrounded by ghost cells: word before the row, bits after the
+   * last cell and rows before the first and after the last one. They are zero
+   * except between refreshGhosts() and clearGhosts().
+   */
+  const uint64_t* getRow(size_t posX) const {
+    return cells.data() + (posX + 1) * rowStride + 1;
+  }
+
+  uint64_t* getRow(size_t posX) {
+    return cells.data() + (posX + 1) * rowStride + 1;
+  }
+
+  /**
+   * Checks life in the cell without looping, position must be inside the field.
+   */
+  bool isLifeAt(size_t posX, size_t posY) const {
+    return getRowCell(getRow(posX), posY);
+  }
+
+  /**
+   * Sets life in the cell without looping, position must be inside the field.
+   */
+  void setLifeAt(size_t posX, size_t posY, bool life) {
+    uint64_t& word = getRow(posX)[posY / 64];
+    const uint64_t mask = uint64_t(1) << (posY % 64);
+    word = life ? word | mask : word & ~mask;
+  }
+
+  /**
+   * @return Approximate number of bytes used by the field.
+   */
+  size_t getMemoryUsage() const;
+
+  /**
+   * Fills the ghost cells around the field according to the boundary (cells of
+   * the opposite edges for torus), so neighbours of every cell can be read
+   * without looping. Takes time proportional to the perimeter of the field.
+   */
+  void refreshGhosts();
+
+  /**
+   * Zeroes ghost cells back, takes time proportional to the perimeter.
+   */
+  void clearGhosts();
+
   GameField& operator=(const GameField& copy);
 
+  /**
+   * Takes cells of the field without copying, own cells are released to the
+   * pool. Moved field becomes empty.
+   */
+  GameField& operator=(GameField&& toMove) noexcept;
+
+  /**
+   * Exchanges sizes, boundaries and cells of the fields without copying.
+   */
+  void swap(GameField& other) noexcept;
+
+  /**
+   * Compares sizes and cells, boundaries are not compared.
+   */
   bool operator==(const GameField& equal) const;
 
  private:
   size_t width;
   size_t height;
-  std::vector<std::vector<bool>> field;
+  size_t rowWords;
+  size_t rowStride;
+  FieldBoundary boundary = BOUNDARY_TORUS;
+
+  // Packed cells, row by row, with ghost cells around, taken from the pool
+  FieldBuffer cells;
+
+  template <FieldBoundary Boundary>
+  void refreshGhosts();
+
+  /**
+   * Parses lines of the string range into rows starting from the given line.
+   * Throws BadGameFieldException with the line number in the whole string.
+   */
+  void parseLines(const std::string& str,
+                  size_t begin,
+                  size_t end,
+                  size_t line);
+
+  /**
+   * Parses the string range cell by cell, handles '\r' and finds errors.
+   */
+  void parseCells(const std::string& str,
+                  size_t begin,
+                  size_t end,
+                  size_t line);
 
   friend SubGameField;
-  friend std::ostream& operator<<(std::ostream& stream, const GameField& field);
 };
 
+inline void swap(GameField& first, GameField& second) noexcept {
+  first.swap(second);
+}
+
 /**
  * Outputs field to stream.
  * Living Cell: '#'
@@ -85,11 +287,9 @@ class GameField::SubGameField {
 
  private:
   const size_t posX;
-  const size_t height;
-  std::vector<std::vector<bool>>& field;
+  GameField& game;
 
-  SubGameField(size_t posX, GameField& game)
-      : posX(posX), field(game.field), height(game.height) {}
+  SubGameField(size_t posX, GameField& game) : posX(posX), game(game) {}
 
   SubGameField& operator=(SubGameField const&) = delete;
 
@@ -111,10 +311,10 @@ class GameField::SubGameField::Cell {
  private:
   const size_t posX;
   const size_t posY;
-  std::vector<std::vector<bool>>& field;
+  GameField& game;
 
-  Cell(size_t posX, size_t posY, std::vector<std::vector<bool>>& field)
-      : posX(posX), posY(posY), field(field) {}
+  Cell(size_t posX, size_t posY, GameField& game)
+      : posX(posX), posY(posY), game(game) {}
 
   friend SubGameField;
 };
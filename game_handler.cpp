@@ -6,15 +6,43 @@
 //  Copyright © 2017 Кирилл. All rights reserved.
 //
 
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
+#include "band_workers.h"
+#include "census.h"
 #include "game_handler.h"
+#include "pattern_library.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include "soup_search.h"
 
 static const std::string DEFAULT_SAVE_FILENAME = "game_of_life.fld";
 
+static const std::string DEFAULT_SNAPSHOT_FILENAME = "game_of_life.snap";
+
+// Probability of life in cells of random fields.
+static const double DEFAULT_DENSITY = 0.5;
+
+// Number of the most frequent objects printed by census command.
+static const size_t DEFAULT_CENSUS_LIMIT = 10;
+
+// Angles of pattern rotations by quarter turns.
+static const std::vector<std::string> ROTATION_NAMES = {"0", "90", "180",
+                                                        "270"};
+
+// Names of boundaries in the order of FieldBoundary values.
+static const std::vector<std::string> BOUNDARY_NAMES = {"torus", "dead",
+                                                        "mirror", "klein"};
+
 // Key codes
 static const int KEY_N = 110;
 static const int KEY_B = 98;
@@ -22,24 +50,37 @@ static const int KEY_R = 114;
 static const int KEY_C = 99;
 static const int KEY_I = 105;
 static const int KEY_Q = 113;
+static const int KEY_S = 115;
+static const int KEY_PLUS = 43;
+static const int KEY_EQUALS = 61;
+static const int KEY_MINUS = 45;
 
 static const int KEY_UP = 259;
 static const int KEY_DOWN = 258;
 static const int KEY_LEFT = 260;
 static const int KEY_RIGHT = 261;
 static const int KEY_ENTER = 10;
+static const int KEY_BACKSPACE = 263;
+static const int KEY_DELETE = 127;
 
-// Delay in tenths of a second when the next step is updated (for multi steps).
-static const size_t STEP_UPDATE_DELAY = 1;
+// Shown in the command line during running steps.
+static const std::string STEPS_PROMPT =
+    "Making steps... Type commands or press I for interrupt.";
 
-// Number of living cells around the dead for the birth of life.
-static const size_t BORN_LIFE = 3;
+// Commands making steps, they are not executed during running steps.
+static const std::string STEPS_COMMANDS[] = {"step", "run", "soup"};
 
-// Minimum number of living cells around the living to continue life.
-static const size_t DEATH_LONELINESS = 2;
+// Maximum number of scripts executed one inside another.
+static const size_t MAX_SCRIPT_DEPTH = 16;
 
-// Maximum number of living cells around the living to continue life.
-static const size_t DEATH_OVERPOPULATION = 3;
+// Slowest speed of running steps in generations per second.
+static const double MIN_SPEED = 1;
+
+// Side of the square field tile for changes tracking.
+static const size_t TILE_SIZE = 8;
+
+// Minimum period of the steps per second measure.
+static const std::chrono::milliseconds RATE_MEASURE_PERIOD(500);
 
 // ==================== Command handlers ====================
 
@@ -90,6 +131,208 @@ static void commandSet(const std::vector<std::string>& args,
       << std::endl;
 }
 
+/**
+ * Places the pattern from the library, rotated clockwise by the angle.
+ * Without arguments prints names of patterns.
+ * Arguments: <pattern> <pos X> <pos Y> [0 | 90 | 180 | 270]
+ */
+static void commandPlace(const std::vector<std::string>& args,
+                         GameManager& game,
+                         std::ostream& out) {
+  PatternLibrary& library = PatternLibrary::getInstance();
+  if (args.size() < 3) {
+    out << "Need args: <pattern> <pos X> <pos Y> [0 | 90 | 180 | 270]"
+        << std::endl
+        << "Patterns:";
+    for (const std::string& name : library.getNames())
+      out << " " << name;
+    out << std::endl;
+    return;
+  }
+
+  const Pattern* pattern = library.find(args[0]);
+  if (pattern == nullptr) {
+    out << "Unknown pattern \"" << args[0] << "\"." << std::endl;
+    return;
+  }
+  size_t rotation = 0;
+  if (args.size() > 3) {
+    rotation = std::find(ROTATION_NAMES.begin(), ROTATION_NAMES.end(),
+                         args[3]) -
+               ROTATION_NAMES.begin();
+    if (rotation == ROTATION_NAMES.size()) {
+      out << "Unknown rotation \"" << args[3] << "\"." << std::endl;
+      return;
+    }
+  }
+
+  const GameField& cells = pattern->getRotation(rotation);
+  if (cells.getWidth() > game.getWidth() ||
+      cells.getHeight() > game.getHeight()) {
+    out << "Pattern is larger than the field." << std::endl;
+    return;
+  }
+  // Position is looped like the position of the set command
+  const GameField::SubGameField::Cell cell =
+      game.getCurrentField()[atoi(args[1].c_str())][atoi(args[2].c_str())];
+  game.placePattern(cells, cell.getX(), cell.getY());
+  out << "Pattern \"" << args[0] << "\" placed." << std::endl;
+}
+
+/**
+ * Reads the size of the region.
+ *
+ * @return false, if the argument is not a non-negative number.
+ */
+static bool readSize(const std::string& arg, size_t& size) {
+  if (arg.empty() || !std::isdigit(static_cast<unsigned char>(arg[0])))
+    return false;
+  char* end;
+  size = std::strtoul(arg.c_str(), &end, 10);
+  return *end == '\0';
+}
+
+/**
+ * Reads the region "<pos X> <pos Y> <width> <height>" from the arguments, the
+ * position is looped like the position of the set command.
+ *
+ * @return false, if there are not enough arguments, the size is not a number
+ * or the region is larger than the field, the message is printed then.
+ */
+static bool readRegion(const std::vector<std::string>& args,
+                       GameManager& game,
+                       std::ostream& out,
+                       size_t& posX,
+                       size_t& posY,
+                       size_t& regionWidth,
+                       size_t& regionHeight) {
+  if (args.size() < 4 || !readSize(args[2], regionWidth) ||
+      !readSize(args[3], regionHeight)) {
+    out << "Need args: <pos X> <pos Y> <width> <height>" << std::endl;
+    return false;
+  }
+  const GameField::SubGameField::Cell cell =
+      game.getCurrentField()[atoi(args[0].c_str())][atoi(args[1].c_str())];
+  posX = cell.getX();
+  posY = cell.getY();
+  if (regionWidth > game.getWidth() || regionHeight > game.getHeight()) {
+    out << "Region is larger than the field." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Makes all cells of the region alive.
+ * Arguments: <pos X> <pos Y> <width> <height>
+ */
+static void commandFill(const std::vector<std::string>& args,
+                        GameManager& game,
+                        std::ostream& out) {
+  size_t posX, posY, regionWidth, regionHeight;
+  if (!readRegion(args, game, out, posX, posY, regionWidth, regionHeight))
+    return;
+  game.fillRegion(posX, posY, regionWidth, regionHeight, true);
+  out << "Region filled." << std::endl;
+}
+
+/**
+ * Kills all cells of the region.
+ * Arguments: <pos X> <pos Y> <width> <height>
+ */
+static void commandClear(const std::vector<std::string>& args,
+                         GameManager& game,
+                         std::ostream& out) {
+  size_t posX, posY, regionWidth, regionHeight;
+  if (!readRegion(args, game, out, posX, posY, regionWidth, regionHeight))
+    return;
+  game.fillRegion(posX, posY, regionWidth, regionHeight, false);
+  out << "Region cleared." << std::endl;
+}
+
+/**
+ * Replaces the field with randomly placed cells and resets the steps counter,
+ * or fills the region with them. Without seed the generator is seeded by the
+ * clock.
+ * Arguments: [density] [seed] or
+ * <pos X> <pos Y> <width> <height> <density> [seed]
+ */
+static void commandRandom(const std::vector<std::string>& args,
+                          GameManager& game,
+                          std::ostream& out) {
+  const bool isRegion = args.size() > 2;
+  if (isRegion && args.size() < 5) {
+    out << "Need args: [density] [seed] or <pos X> <pos Y> <width> <height> "
+           "<density> [seed]"
+        << std::endl;
+    return;
+  }
+  const size_t densityArg = isRegion ? 4 : 0;
+  const double density =
+      args.size() > densityArg ? stod(args[densityArg]) : DEFAULT_DENSITY;
+  if (!std::isfinite(density)) {
+    out << "Density must be a finite number." << std::endl;
+    return;
+  }
+  const uint64_t seed =
+      args.size() > densityArg + 1
+          ? stoull(args[densityArg + 1])
+          : std::chrono::steady_clock::now().time_since_epoch().count();
+
+  if (!isRegion) {
+    GameField field(GameField::createRandom(game.getWidth(), game.getHeight(),
+                                            density, seed));
+    field.setBoundary(game.getCurrentField().getBoundary());
+    game.reset(std::move(field));
+    out << "Field filled randomly with seed " << seed << "." << std::endl;
+    return;
+  }
+
+  size_t posX, posY, regionWidth, regionHeight;
+  if (!readRegion(args, game, out, posX, posY, regionWidth, regionHeight))
+    return;
+  game.randomizeRegion(posX, posY, regionWidth, regionHeight, density, seed);
+  out << "Region filled randomly with seed " << seed << "." << std::endl;
+}
+
+/**
+ * Copies cells of the region for the paste command.
+ * Arguments: <pos X> <pos Y> <width> <height>
+ */
+static void commandCopy(const std::vector<std::string>& args,
+                        GameManager& game,
+                        std::ostream& out) {
+  size_t posX, posY, regionWidth, regionHeight;
+  if (!readRegion(args, game, out, posX, posY, regionWidth, regionHeight))
+    return;
+  game.copyRegion(posX, posY, regionWidth, regionHeight);
+  out << "Region " << regionWidth << "x" << regionHeight << " copied."
+      << std::endl;
+}
+
+/**
+ * Replaces cells at the position with the copied region.
+ * Arguments: <pos X> <pos Y>
+ */
+static void commandPaste(const std::vector<std::string>& args,
+                         GameManager& game,
+                         std::ostream& out) {
+  if (args.size() < 2) {
+    out << "Need args: <pos X> <pos Y>" << std::endl;
+    return;
+  }
+  const GameField& clipboard = game.getClipboard();
+  if (clipboard.getWidth() > game.getWidth() ||
+      clipboard.getHeight() > game.getHeight()) {
+    out << "Region is larger than the field." << std::endl;
+    return;
+  }
+  const GameField::SubGameField::Cell cell =
+      game.getCurrentField()[atoi(args[0].c_str())][atoi(args[1].c_str())];
+  game.pasteRegion(cell.getX(), cell.getY());
+  out << "Region pasted." << std::endl;
+}
+
 /**
  * Performs the specified number of steps. If there is no argument, it performs
  * 1 step. If the argument is '-', performs an infinite number of steps, until
@@ -107,14 +350,26 @@ static void commandStep(const std::vector<std::string>& args,
       steps = stoi(args[0]);
   }
 
-  game.getViewHandler().updateCommandLine(
-      "Making steps... Press I for interrupt.");
+  // Steps of scripts are not delayed and can not be interrupted, so infinite
+  // steps of a never periodic field would not end
+  const bool interactive = !game.isRenderingSuppressed();
+  if (isInfinity && !interactive)
+    throw std::invalid_argument("Need a step count in scripts");
+  if (interactive)
+    game.getViewHandler().updateCommandLine(STEPS_PROMPT);
 
   size_t counter = 0;
-  for (; counter < steps || isInfinity; counter++) {
+  while (counter < steps || isInfinity) {
     game.nextStep();
-    InputResult result = game.getViewHandler().waitForInput(STEP_UPDATE_DELAY);
-    if (result.isKeyboard() && result.getKey() == KEY_I)
+    counter++;
+    // Periodic field will never change, so infinite steps are stopped and
+    // whole periods are skipped
+    if (isInfinity && game.getPeriod() != 0) {
+      out << "Field became periodic with period " << game.getPeriod() << ". ";
+      break;
+    } else if (game.getPeriod() != 0)
+      counter += game.fastForward(steps - counter);
+    if (interactive && game.pollConsole())
       break;
   }
 
@@ -145,20 +400,50 @@ static void commandSave(const std::vector<std::string>& args,
   if (args.size() > 0)
     filename = args[0];
 
+  PROFILE_SCOPE(PROFILE_SAVE);
   std::ofstream file(filename);
   if (!file.is_open()) {
     out << "Cannot create file \"" << filename << "\"." << std::endl;
     return;
   }
 
-  file << game.getCurrentField() << std::endl;
+  // Field is written by whole formatted rows, the stream is flushed on close
+  file << game.getCurrentField() << '\n';
+  PROFILE_COUNT(COUNTER_BYTES_SAVED, file.tellp());
   file.close();
 
   out << "Game field saved to \"" << filename << "\"." << std::endl;
 }
 
 /**
- * Loads field from file.
+ * Reads the whole file. Regular files are read by their size at once, other
+ * files like pipes are read as a stream.
+ *
+ * @return False, if the file cannot be read.
+ */
+static bool readFile(const std::string& filename, std::string& content) {
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0 || S_ISDIR(info.st_mode))
+    return false;
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  if (S_ISREG(info.st_mode)) {
+    content.resize(info.st_size);
+    file.read(&content[0], content.size());
+    // File may be truncated after its size was taken
+    content.resize(file.gcount());
+  } else {
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    content = stream.str();
+  }
+  return !file.bad();
+}
+
+/**
+ * Loads field from file, files with ".rle" extension are read as RLE patterns.
  * Arguments: [filename]
  */
 static void commandLoad(const std::vector<std::string>& args,
@@ -168,25 +453,28 @@ static void commandLoad(const std::vector<std::string>& args,
   if (args.size() > 0)
     filename = args[0];
 
-  std::ifstream file(filename);
-  if (!file.is_open()) {
+  PROFILE_SCOPE(PROFILE_LOAD);
+  // File is read at once, lines are split by the parallel parser
+  std::string fileContent;
+  if (!readFile(filename, fileContent)) {
     out << "Cannot load file \"" << filename << "\"" << std::endl;
     return;
   }
-
-  std::ostringstream fileContent;
-  std::string line;
-  while (std::getline(file, line))
-    fileContent << line << std::endl;
-  file.close();
+  PROFILE_COUNT(COUNTER_BYTES_LOADED, fileContent.size());
 
   try {
-    GameField field(fileContent.str());
+    // Patterns in the RLE format are loaded by extension
+    const bool isRle =
+        filename.size() > RLE_EXTENSION.size() &&
+        filename.compare(filename.size() - RLE_EXTENSION.size(),
+                         RLE_EXTENSION.size(), RLE_EXTENSION) == 0;
+    GameField field(isRle ? parseRle(fileContent) : GameField(fileContent));
+    field.setBoundary(game.getCurrentField().getBoundary());
     if (!game.canCreateFieldWithSizes(field.getWidth(), field.getHeight())) {
       out << "Cannot place game field on this terminal size." << std::endl;
       return;
     }
-    game.reset(field);
+    game.reset(std::move(field));
   } catch (const BadGameFieldException& e) {
     out << "Cannot parse field: " << e.what() << std::endl;
     return;
@@ -195,18 +483,245 @@ static void commandLoad(const std::vector<std::string>& args,
   out << "Game \"" << filename << "\" loaded successfully." << std::endl;
 }
 
+/**
+ * Executes commands from the script file.
+ * Arguments: <filename>
+ */
+static void commandRun(const std::vector<std::string>& args,
+                       GameManager& game,
+                       std::ostream& out) {
+  if (args.empty()) {
+    out << "Need args: <filename>" << std::endl;
+    return;
+  }
+  std::ifstream file(args[0]);
+  if (!file.is_open()) {
+    out << "Cannot load file \"" << args[0] << "\"" << std::endl;
+    return;
+  }
+  if (game.runScript(file, out))
+    out << "Script \"" << args[0] << "\" done." << std::endl;
+}
+
+/**
+ * @return Speed of running steps for messages.
+ */
+static std::string describeSpeed(double speed) {
+  if (speed == 0)
+    return "max";
+  std::ostringstream out;
+  out << speed << " gen/s";
+  return out.str();
+}
+
+/**
+ * Prints or changes speed of running steps, "max" runs steps without delay.
+ * Arguments: [generations per second | max]
+ */
+static void commandSpeed(const std::vector<std::string>& args,
+                         GameManager& game,
+                         std::ostream& out) {
+  if (!args.empty()) {
+    const double speed = args[0] == "max" ? 0 : atof(args[0].c_str());
+    // Too slow speeds overflow the time between generations
+    if (args[0] != "max" && !(speed >= MIN_SPEED)) {
+      out << "Need args: [generations per second | max], the slowest speed is "
+          << describeSpeed(MIN_SPEED) << "." << std::endl;
+      return;
+    }
+    game.setSpeed(speed);
+  }
+  out << "Speed: " << describeSpeed(game.getSpeed()) << "." << std::endl;
+}
+
+/**
+ * Prints profiling statistics of hot paths.
+ * Arguments: [reset | json <filename>]
+ */
+static void commandStats(const std::vector<std::string>& args,
+                         GameManager& game,
+                         std::ostream& out) {
+#ifdef PROFILING
+  if (args.empty())
+    Profiler::getInstance().writeText(out);
+  else if (args[0] == "reset") {
+    Profiler::getInstance().reset();
+    out << "Statistics reseted." << std::endl;
+  } else if (args[0] == "json" && args.size() == 2) {
+    std::ofstream file(args[1]);
+    if (!file.is_open()) {
+      out << "Cannot create file \"" << args[1] << "\"." << std::endl;
+      return;
+    }
+    Profiler::getInstance().writeJson(file);
+    out << "Statistics saved to \"" << args[1] << "\"." << std::endl;
+  } else
+    out << "Need args: [reset | json <filename>]" << std::endl;
+#else
+  out << "Profiling is disabled in this build." << std::endl;
+#endif
+}
+
+/**
+ * Saves field to the compressed snapshot or loads it back.
+ * Arguments: <save | load> [filename]
+ */
+static void commandSnapshot(const std::vector<std::string>& args,
+                            GameManager& game,
+                            std::ostream& out) {
+  if (args.empty() || (args[0] != "save" && args[0] != "load")) {
+    out << "Need args: <save | load> [filename]" << std::endl;
+    return;
+  }
+  const std::string filename =
+      args.size() > 1 ? args[1] : DEFAULT_SNAPSHOT_FILENAME;
+
+  if (args[0] == "save") {
+    PROFILE_SCOPE(PROFILE_SAVE);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+      out << "Cannot create file \"" << filename << "\"." << std::endl;
+      return;
+    }
+    writeSnapshot(file, game.getCurrentField());
+    PROFILE_COUNT(COUNTER_BYTES_SAVED, file.tellp());
+    out << "Snapshot saved to \"" << filename << "\"." << std::endl;
+    return;
+  }
+
+  PROFILE_SCOPE(PROFILE_LOAD);
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    out << "Cannot load file \"" << filename << "\"" << std::endl;
+    return;
+  }
+  try {
+    GameField field(readSnapshot(file));
+    // Snapshot is read as a stream, pipes have no position to count
+    file.clear();
+    PROFILE_COUNT(COUNTER_BYTES_LOADED,
+                  std::max<std::streamoff>(file.tellg(), 0));
+    if (!game.canCreateFieldWithSizes(field.getWidth(), field.getHeight())) {
+      out << "Cannot place game field on this terminal size." << std::endl;
+      return;
+    }
+    game.reset(std::move(field));
+  } catch (const std::runtime_error& e) {
+    out << "Cannot read snapshot: " << e.what() << std::endl;
+    return;
+  }
+  out << "Snapshot loaded from \"" << filename << "\"." << std::endl;
+}
+
+/**
+ * Prints number of living cells and changes made by the last step.
+ */
+static void commandPopulation(const std::vector<std::string>& args,
+                              GameManager& game,
+                              std::ostream& out) {
+  out << "Population: " << game.getPopulation()
+      << ", last step births: " << game.getBirths()
+      << ", deaths: " << game.getDeaths() << "." << std::endl;
+}
+
+/**
+ * Counts connected objects on the field and prints the most frequent.
+ * Arguments: [number of printed objects]
+ */
+static void commandCensus(const std::vector<std::string>& args,
+                          GameManager& game,
+                          std::ostream& out) {
+  size_t limit = args.size() > 0 ? stoul(args[0]) : DEFAULT_CENSUS_LIMIT;
+
+  std::vector<std::pair<size_t, std::string>> objects;
+  for (auto count : takeCensus(game.getCurrentField()))
+    objects.push_back(std::make_pair(count.second, count.first));
+  std::sort(objects.begin(), objects.end(),
+            [](const std::pair<size_t, std::string>& first,
+               const std::pair<size_t, std::string>& second) {
+              return first.first > second.first ||
+                     (first.first == second.first &&
+                      first.second < second.second);
+            });
+
+  out << "Objects kinds: " << objects.size() << std::endl;
+  for (size_t i = 0; i < objects.size() && i < limit; i++)
+    out << objects[i].second << ": " << objects[i].first << std::endl;
+}
+
+/**
+ * Runs random soups of the current field size until they become static or
+ * periodic and prints counts of the final states.
+ * Arguments: <soups count> [seed] [threads]
+ */
+static void commandSoup(const std::vector<std::string>& args,
+                        GameManager& game,
+                        std::ostream& out) {
+  if (args.empty()) {
+    out << "Need args: <soups count> [seed] [threads]" << std::endl;
+    return;
+  }
+  size_t soups = stoul(args[0]);
+  uint64_t seed = args.size() > 1 ? stoull(args[1]) : 0;
+  size_t threads = args.size() > 2 ? stoul(args[2]) : 0;
+
+  game.getViewHandler().updateCommandLine("Searching soups...");
+  SoupSearch search(game.getWidth(), game.getHeight());
+  out << search.run(soups, seed, threads);
+}
+
+/**
+ * Prints or changes the rule for neighbours of the edge cells.
+ * Arguments: [torus | dead | mirror | klein]
+ */
+static void commandBoundary(const std::vector<std::string>& args,
+                            GameManager& game,
+                            std::ostream& out) {
+  if (args.size() > 0) {
+    size_t boundary = 0;
+    while (boundary < BOUNDARY_NAMES.size() &&
+           BOUNDARY_NAMES[boundary] != args[0])
+      boundary++;
+    if (boundary == BOUNDARY_NAMES.size()) {
+      out << "Unknown boundary \"" << args[0] << "\"." << std::endl;
+      return;
+    }
+    game.setBoundary(static_cast<FieldBoundary>(boundary));
+  }
+  out << "Boundary: " << BOUNDARY_NAMES[game.getCurrentField().getBoundary()]
+      << "." << std::endl;
+}
+
 GameManager::GameManager(size_t width, size_t height, ViewHandler& viewHandler)
     : width(width),
       height(height),
       gameField(GameField(width, height)),
       viewHandler(viewHandler),
       previousStep(GameField(0, 0)) {
+  registerDefaultCommands();
+}
+
+void GameManager::registerDefaultCommands() {
   registerCommand("reset", &commandReset);
   registerCommand("set", &commandSet);
+  registerCommand("place", &commandPlace);
+  registerCommand("fill", &commandFill);
+  registerCommand("clear", &commandClear);
+  registerCommand("random", &commandRandom);
+  registerCommand("copy", &commandCopy);
+  registerCommand("paste", &commandPaste);
   registerCommand("step", &commandStep);
   registerCommand("back", &commandBack);
   registerCommand("save", &commandSave);
   registerCommand("load", &commandLoad);
+  registerCommand("run", &commandRun);
+  registerCommand("stats", &commandStats);
+  registerCommand("speed", &commandSpeed);
+  registerCommand("pop", &commandPopulation);
+  registerCommand("soup", &commandSoup);
+  registerCommand("census", &commandCensus);
+  registerCommand("boundary", &commandBoundary);
+  registerCommand("snapshot", &commandSnapshot);
 }
 
 int GameManager::runGame() {
@@ -231,43 +746,264 @@ int GameManager::runGame() {
     } else
       onMousePressed(static_cast<int>(result.getPosX()),
                      static_cast<int>(result.getPosY()));
+    const std::string output(executeQueuedCommands());
+    if (!output.empty())
+      viewHandler.updateCommandLine(output);
   }
 
   return 0;
 }
 
-void GameManager::nextStep() {
-  previousStep = gameField;
-  for (int i = 0; i < width; i++) {
-    for (int j = 0; j < height; j++) {
-      size_t life = countLifeAround(i, j);
-      bool hasLife = previousStep[i][j].isLife();
-      if (hasLife && (life < DEATH_LONELINESS || life > DEATH_OVERPOPULATION))
-        gameField[i][j].kill();
-      else if (!hasLife && life == BORN_LIFE)
-        gameField[i][j].bornLife();
+/**
+ * @return Random looking hash of the cell position, which is mixed into the
+ * field hash by XOR, if the cell is alive.
+ */
+static uint64_t getCellHash(size_t posX, size_t posY, size_t height) {
+  return mix64(posX * height + posY + GOLDEN_GAMMA);
+}
+
+/**
+ * Computes the next state of 64 cells of the row word at once.
+ * Neighbour rows and ghost cells around the row must be readable, so bits
+ * of the neighbour words are shifted in without any looping.
+ *
+ * @return Next state of the word, bits after the last cell are not cleared.
+ */
+static inline uint64_t nextWord(const uint64_t* above,
+                                const uint64_t* row,
+                                const uint64_t* below,
+                                size_t word) {
+  uint64_t ones = 0, twos = 0, fours = 0;
+  // Left neighbours come from lower bits, right ones from higher bits
+  addNeighbour(above[word] << 1 | above[word - 1] >> 63, ones, twos, fours);
+  addNeighbour(above[word], ones, twos, fours);
+  addNeighbour(above[word] >> 1 | above[word + 1] << 63, ones, twos, fours);
+  addNeighbour(row[word] << 1 | row[word - 1] >> 63, ones, twos, fours);
+  addNeighbour(row[word] >> 1 | row[word + 1] << 63, ones, twos, fours);
+  addNeighbour(below[word] << 1 | below[word - 1] >> 63, ones, twos, fours);
+  addNeighbour(below[word], ones, twos, fours);
+  addNeighbour(below[word] >> 1 | below[word + 1] << 63, ones, twos, fours);
+
+  // Born with three neighbours, survives with two or three
+  return ~fours & twos & (ones | row[word]);
+}
+
+static uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start) {
+  std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+  return time.count();
+}
+
+/**
+ * Changes made by the step in a band of rows.
+ */
+class StepChanges {
+ public:
+  size_t births = 0;
+  size_t deaths = 0;
+  uint64_t hash = 0;
+  size_t activeTiles = 0;
+};
+
+void GameManager::stepRows(size_t begin, size_t end, StepChanges& changes) {
+  const size_t words = previousStep.getRowWords();
+  const size_t stride = previousStep.getRowStride();
+  const uint64_t lastWordMask =
+      height % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (height % 64)) - 1;
+  for (size_t i = begin; i < end; i++) {
+    const uint64_t* row = previousStep.getRow(i);
+    uint64_t* next = gameField.getRow(i);
+    for (size_t k = 0; k < words; k++) {
+      // Ghost cell after the row is in the bits of the last word
+      const uint64_t mask = k + 1 == words ? lastWordMask : ~uint64_t(0);
+      const uint64_t cells =
+          nextWord(row - stride, row, row + stride, k) & mask;
+      next[k] = cells;
+      uint64_t changed = cells ^ (row[k] & mask);
+      if (changed == 0)
+        continue;
+      changes.births += countBits(changed & cells);
+      changes.deaths += countBits(changed & row[k]);
+      while (changed != 0) {
+        size_t j = k * 64 + findFirstBit(changed);
+        changes.hash ^= getCellHash(i, j, height);
+        changes.activeTiles += markTileChanged(i, j);
+        changed &= changed - 1;
+      }
     }
   }
+}
+
+void GameManager::nextStep() {
+  auto start = std::chrono::steady_clock::now();
+  // Current generation becomes the previous one without copying, the next one
+  // is written over the buffer of the older generation
+  if (previousStep.getWidth() != width || previousStep.getHeight() != height)
+    previousStep = GameField(width, height);
+  previousStep.swap(gameField);
+  gameField.setBoundary(previousStep.getBoundary());
+  undoEdit = false;
+  previousPopulation = population;
+  previousHash = fieldHash;
+  size_t tilesCount = ((width + TILE_SIZE - 1) / TILE_SIZE) *
+                      ((height + TILE_SIZE - 1) / TILE_SIZE);
+  changedTiles.assign(tilesCount, 0);
+  activeTiles = 0;
+  births = deaths = 0;
+  // Loop is applied once to the ghost cells, the kernel never wraps
+  previousStep.refreshGhosts();
+
+  // Large fields are stepped by bands, each by the thread, which first touched
+  // its memory
+  std::vector<StepChanges> bands(BandWorkers::getInstance().getThreads());
+  runInBands(width, TILE_SIZE, width * previousStep.getRowStride(),
+             [&](size_t band, size_t begin, size_t end) {
+               stepRows(begin, end, bands[band]);
+             });
+  for (const StepChanges& band : bands) {
+    births += band.births;
+    deaths += band.deaths;
+    fieldHash ^= band.hash;
+    activeTiles += band.activeTiles;
+  }
+
+  previousStep.clearGhosts();
+  population += births;
+  population -= deaths;
+  detectPeriod();
   stepsCounter++;
   hasUndo = true;
+  uint64_t time = nanosecondsSince(start);
+  statistics.stepMilliseconds = time / 1e6;
+  PROFILE_RECORD(PROFILE_STEP, time);
+  PROFILE_COUNT(COUNTER_STEPS, 1);
+  updateGenerationRate();
   update();
 }
 
 bool GameManager::setCellAt(int posX, int posY) {
-  previousStep = gameField;
-  if (gameField[posX][posY].isLife())
-    gameField[posX][posY].kill();
-  else
-    gameField[posX][posY].bornLife();
-  hasUndo = true;
+  // Only the word of the cell is remembered for cancelling
+  beginEdit();
+  GameField::SubGameField::Cell cell = gameField[posX][posY];
+  const uint64_t mask = uint64_t(1) << (cell.getY() % 64);
+  editWord(cell.getX(), cell.getY() / 64, cell.isLife() ? 0 : mask, mask);
+  update();
+  return cell.isLife();
+}
+
+void GameManager::placePattern(const GameField& pattern,
+                               size_t posX,
+                               size_t posY) {
+  writeRegion(pattern, posX, posY, true);
+}
+
+void GameManager::fillRegion(size_t posX,
+                             size_t posY,
+                             size_t regionWidth,
+                             size_t regionHeight,
+                             bool life) {
+  if (regionWidth > width || regionHeight > height)
+    throw std::invalid_argument("Region is larger than the field");
+
+  beginEdit();
+  const uint64_t cells = life ? ~uint64_t(0) : 0;
+  for (size_t i = 0; i < regionWidth; i++)
+    for (size_t j = 0; j < regionHeight; j += 64)
+      editRowCells((posX + i) % width, (posY + j) % height, cells,
+                   ~uint64_t(0), std::min<size_t>(64, regionHeight - j));
+  update();
+}
+
+void GameManager::randomizeRegion(size_t posX,
+                                  size_t posY,
+                                  size_t regionWidth,
+                                  size_t regionHeight,
+                                  double density,
+                                  uint64_t seed) {
+  writeRegion(
+      GameField::createRandom(regionWidth, regionHeight, density, seed), posX,
+      posY, false);
+}
+
+/**
+ * Reads cells of the packed row starting from the position, cells after the
+ * row end are continued from its beginning.
+ *
+ * @param count Number of cells, not more than 64 and the row length.
+ */
+static uint64_t readRowCells(const uint64_t* row,
+                             size_t rowLength,
+                             size_t pos,
+                             size_t count) {
+  if (pos + count > rowLength) {
+    const size_t first = rowLength - pos;
+    return readRowCells(row, rowLength, pos, first) |
+           readRowCells(row, rowLength, 0, count - first) << first;
+  }
+  const size_t word = pos / 64;
+  const size_t shift = pos % 64;
+  uint64_t cells = row[word] >> shift;
+  if (shift != 0 && shift + count > 64)
+    cells |= row[word + 1] << (64 - shift);
+  return count < 64 ? cells & ((uint64_t(1) << count) - 1) : cells;
+}
+
+void GameManager::copyRegion(size_t posX,
+                             size_t posY,
+                             size_t regionWidth,
+                             size_t regionHeight) {
+  if (regionWidth > width || regionHeight > height)
+    throw std::invalid_argument("Region is larger than the field");
+
+  GameField region(regionWidth, regionHeight);
+  for (size_t i = 0; i < regionWidth; i++) {
+    const uint64_t* row = gameField.getRow((posX + i) % width);
+    uint64_t* regionRow = region.getRow(i);
+    for (size_t k = 0; k < region.getRowWords(); k++)
+      regionRow[k] =
+          readRowCells(row, height, (posY + k * 64) % height,
+                       std::min<size_t>(64, regionHeight - k * 64));
+  }
+  clipboard = std::move(region);
+}
+
+void GameManager::pasteRegion(size_t posX, size_t posY) {
+  writeRegion(clipboard, posX, posY, false);
+}
+
+const GameField& GameManager::getClipboard() const {
+  return clipboard;
+}
+
+void GameManager::writeRegion(const GameField& region,
+                              size_t posX,
+                              size_t posY,
+                              bool onlyLiving) {
+  if (region.getWidth() > width || region.getHeight() > height)
+    throw std::invalid_argument("Region is larger than the field");
+
+  beginEdit();
+  // Region rows are written by words, only cells under the mask are changed
+  for (size_t i = 0; i < region.getWidth(); i++) {
+    const uint64_t* row = region.getRow(i);
+    for (size_t k = 0; k < region.getRowWords(); k++) {
+      const size_t count = std::min<size_t>(64, region.getHeight() - k * 64);
+      if (!onlyLiving || row[k] != 0)
+        editRowCells((posX + i) % width, (posY + k * 64) % height, row[k],
+                     onlyLiving ? row[k] : ~uint64_t(0), count);
+    }
+  }
   update();
-  return gameField[posX][posY].isLife();
 }
 
 void GameManager::reset(size_t width, size_t height) {
   this->width = width;
   this->height = height;
+  const FieldBoundary boundary = gameField.getBoundary();
   gameField = GameField(width, height);
+  gameField.setBoundary(boundary);
+  population = births = deaths = 0;
+  fieldHash = 0;
+  resetHistory();
   hasUndo = false;
   stepsCounter = 0;
   cursorY = cursorX = 0;
@@ -276,9 +1012,16 @@ void GameManager::reset(size_t width, size_t height) {
 }
 
 void GameManager::reset(const GameField& field) {
+  reset(GameField(field));
+}
+
+void GameManager::reset(GameField&& field) {
   width = field.getWidth();
   height = field.getHeight();
-  gameField = GameField(field);
+  gameField = std::move(field);
+  recountFieldState();
+  births = deaths = 0;
+  resetHistory();
   hasUndo = false;
   stepsCounter = 0;
   cursorY = cursorX = 0;
@@ -286,57 +1029,193 @@ void GameManager::reset(const GameField& field) {
   update();
 }
 
+void GameManager::setBoundary(FieldBoundary boundary) {
+  gameField.setBoundary(boundary);
+  resetHistory();
+}
+
 void GameManager::infiniteSteps() {
-  getViewHandler().updateCommandLine(
-    "Making steps... Press I for interrupt.");
+  getViewHandler().updateCommandLine(STEPS_PROMPT);
   size_t counter = 0;
   while ( true ) {
     ++counter;
     nextStep();
-    InputResult result = getViewHandler().waitForInput(STEP_UPDATE_DELAY);
-    if (result.isKeyboard() && result.getKey() == KEY_I)
+    // Stop when the field began to repeat itself
+    if (period != 0)
+      break;
+    if (pollConsole())
       break;
   }
   std::cout << "Made " << counter << " step(s)." << std::endl;
 }
 
+size_t GameManager::fastForward(size_t steps) {
+  if (period == 0)
+    return 0;
+  size_t skipped = steps - steps % period;
+  if (skipped != 0) {
+    stepsCounter += skipped;
+    update();
+  }
+  return skipped;
+}
+
 bool GameManager::stepBack() {
   if (!hasUndo)
     return false;
 
-  gameField = previousStep;
+  if (undoEdit) {
+    // Later changes of the same word are cancelled first
+    for (auto word = editedWords.rbegin(); word != editedWords.rend(); word++)
+      gameField.getRow(0)[word->first] = word->second;
+    editedWords.clear();
+    undoEdit = false;
+  } else {
+    // Boundary may be changed after the step, it is kept
+    const FieldBoundary boundary = gameField.getBoundary();
+    gameField = previousStep;
+    gameField.setBoundary(boundary);
+    if (stepsCounter)
+      stepsCounter--;
+  }
+  population = previousPopulation;
+  births = deaths = 0;
+  fieldHash = previousHash;
+  resetHistory();
   hasUndo = false;
-  if (stepsCounter)
-    stepsCounter--;
   update();
 
   return true;
 }
 
-size_t GameManager::countLifeAround(int posX, int posY) const {
-  //   1 2 3
-  // 1 # # #  }
-  // 2 # . #  }- Point is a checking cell
-  // 3 # # #  }
+void GameManager::recountFieldState() {
+  population = 0;
+  fieldHash = 0;
+  for (size_t i = 0; i < width; i++) {
+    const uint64_t* row = gameField.getRow(i);
+    for (size_t word = 0; word < gameField.getRowWords(); word++) {
+      population += countBits(row[word]);
+      for (uint64_t bits = row[word]; bits != 0; bits &= bits - 1)
+        fieldHash ^= getCellHash(i, word * 64 + findFirstBit(bits), height);
+    }
+  }
+}
 
-  size_t lifes = 0;  // Number of living cells around
+void GameManager::rememberHash(uint64_t hash) {
+  if (hashHistory.size() < MAX_DETECTED_PERIOD)
+    hashHistory.push_back(hash);
+  else
+    hashHistory[hashHistoryNext] = hash;
+  hashHistoryNext = (hashHistoryNext + 1) % MAX_DETECTED_PERIOD;
+}
 
-  lifes += previousStep[posX - 1][posY].isLife() ? 1 : 0;  // 2-1
-  lifes += previousStep[posX + 1][posY].isLife() ? 1 : 0;  // 2-3
+void GameManager::resetHistory() {
+  hashHistory.clear();
+  hashHistoryNext = 0;
+  period = 0;
+}
 
-  // 1-1 -> 1-3
-  for (int i = posX - 1; i <= posX + 1; i++)
-    lifes += previousStep[i][posY - 1].isLife() ? 1 : 0;
+void GameManager::detectPeriod() {
+  // History starts from the generation before the first step
+  if (hashHistory.empty())
+    rememberHash(previousHash);
 
-  // 3-1 -> 3-3
-  for (int i = posX - 1; i <= posX + 1; i++)
-    lifes += previousStep[i][posY + 1].isLife() ? 1 : 0;
+  period = births == 0 && deaths == 0 ? 1 : 0;
+  size_t size = hashHistory.size();
+  for (size_t i = 1; period == 0 && i <= size; i++)
+    if (hashHistory[(hashHistoryNext + size - i) % size] == fieldHash)
+      period = i;
 
-  return lifes;
+  rememberHash(fieldHash);
+}
+
+void GameManager::beginEdit() {
+  previousPopulation = population;
+  previousHash = fieldHash;
+  editedWords.clear();
+  undoEdit = true;
+  hasUndo = true;
+  resetHistory();
+}
+
+void GameManager::editRowCells(size_t posX,
+                               size_t posY,
+                               uint64_t cells,
+                               uint64_t mask,
+                               size_t count) {
+  // Cells after the row end are continued from the row beginning
+  if (posY + count > height) {
+    const size_t first = height - posY;
+    editRowCells(posX, posY, cells, mask, first);
+    editRowCells(posX, 0, cells >> first, mask >> first, count - first);
+    return;
+  }
+  if (count < 64)
+    mask &= (uint64_t(1) << count) - 1;
+
+  const size_t word = posY / 64;
+  const size_t shift = posY % 64;
+  editWord(posX, word, cells << shift, mask << shift);
+  if (shift != 0 && shift + count > 64)
+    editWord(posX, word + 1, cells >> (64 - shift), mask >> (64 - shift));
+}
+
+void GameManager::editWord(size_t posX,
+                           size_t word,
+                           uint64_t cells,
+                           uint64_t mask) {
+  uint64_t& current = gameField.getRow(posX)[word];
+  uint64_t changed = (current ^ cells) & mask;
+  if (changed == 0)
+    return;
+
+  editedWords.push_back(
+      std::make_pair(posX * gameField.getRowStride() + word, current));
+  population += countBits(changed & cells);
+  population -= countBits(changed & current);
+  current ^= changed;
+  for (; changed != 0; changed &= changed - 1)
+    fieldHash ^= getCellHash(posX, word * 64 + findFirstBit(changed), height);
+}
+
+bool GameManager::markTileChanged(size_t posX, size_t posY) {
+  size_t tilesInRow = (height + TILE_SIZE - 1) / TILE_SIZE;
+  size_t tile = (posX / TILE_SIZE) * tilesInRow + posY / TILE_SIZE;
+  if (changedTiles[tile])
+    return false;
+  changedTiles[tile] = true;
+  return true;
+}
+
+void GameManager::updateGenerationRate() {
+  rateSteps++;
+  std::chrono::duration<double> time =
+      std::chrono::steady_clock::now() - rateStart;
+  if (time < RATE_MEASURE_PERIOD)
+    return;
+  statistics.generationsPerSecond = rateSteps / time.count();
+  rateSteps = 0;
+  rateStart = std::chrono::steady_clock::now();
 }
 
 void GameManager::update() {
+  if (isRenderingSuppressed())
+    return;
+  auto start = std::chrono::steady_clock::now();
   viewHandler.updateField(gameField, stepsCounter);
+  uint64_t time = nanosecondsSince(start);
+  statistics.renderMilliseconds = time / 1e6;
+  PROFILE_RECORD(PROFILE_RENDER, time);
+  PROFILE_COUNT(COUNTER_RENDERS, 1);
+
+  if (statisticsShown) {
+    statistics.population = population;
+    statistics.activeTiles = activeTiles;
+    statistics.memoryBytes = gameField.getMemoryUsage() +
+                             previousStep.getMemoryUsage() +
+                             changedTiles.capacity();
+    viewHandler.updateStatistics(statistics);
+  }
 }
 
 void GameManager::registerCommand(const std::string& name,
@@ -349,9 +1228,13 @@ void GameManager::registerCommand(const std::string& name,
 bool GameManager::executeCommand(const std::string& name,
                                  const std::vector<std::string>& args,
                                  std::ostream& output) {
+  PROFILE_SCOPE(PROFILE_COMMAND);
   auto executor = commands.find(name);
-  if (executor == commands.end())
+  if (executor == commands.end()) {
+    PROFILE_COUNT(COUNTER_UNKNOWN_COMMANDS, 1);
     return false;
+  }
+  PROFILE_COUNT(COUNTER_COMMANDS, 1);
   executor->second(args, (*this), output);
   return true;
 }
@@ -365,6 +1248,176 @@ static std::vector<std::string> splitString(const std::string& str) {
   return items;
 }
 
+/**
+ * Splits the line into words separated by any spaces.
+ */
+static std::vector<std::string> splitWords(const std::string& line) {
+  std::istringstream input(line);
+  std::vector<std::string> words;
+  for (std::string word; input >> word;)
+    words.push_back(word);
+  return words;
+}
+
+/**
+ * Counts the script as running until the end of the scope, even if a command
+ * throws.
+ */
+class ScriptScope {
+ public:
+  ScriptScope(size_t& depth) : depth(depth) { depth++; }
+
+  ~ScriptScope() { depth--; }
+
+ private:
+  size_t& depth;
+};
+
+bool GameManager::runScript(std::istream& script, std::ostream& output) {
+  if (scriptDepth == MAX_SCRIPT_DEPTH) {
+    output << "Scripts are nested too deeply." << std::endl;
+    scriptFailed = true;
+    return false;
+  }
+  if (scriptDepth == 0)
+    scriptFailed = false;
+
+  {
+    ScriptScope scope(scriptDepth);
+    std::string line;
+    for (size_t number = 1; !scriptFailed && std::getline(script, line);
+         number++) {
+      // Words are separated by any spaces, so scripts may be aligned
+      std::vector<std::string> words(splitWords(line));
+      if (words.empty() || words[0][0] == '#')
+        continue;
+      const std::vector<std::string> args(words.begin() + 1, words.end());
+      try {
+        if (!executeCommand(words[0], args, output)) {
+          output << "Command \"" << words[0] << "\" not found at line "
+                 << number << "." << std::endl;
+          scriptFailed = true;
+        }
+      } catch (const std::exception& e) {
+        output << "Command \"" << words[0] << "\" failed at line " << number
+               << ": " << e.what() << std::endl;
+        scriptFailed = true;
+      }
+    }
+  }
+
+  // Field is drawn once after the whole script
+  if (scriptDepth == 0)
+    update();
+  return !scriptFailed;
+}
+
+void GameManager::queueCommand(const std::string& line) {
+  std::lock_guard<std::mutex> lock(queueMutex);
+  queuedCommands.push_back(line);
+}
+
+std::string GameManager::executeQueuedCommands(bool stepsRunning) {
+  std::ostringstream out;
+  while (true) {
+    std::string line;
+    {
+      // Commands may queue more commands, so the lock is not held by them
+      std::lock_guard<std::mutex> lock(queueMutex);
+      if (queuedCommands.empty())
+        break;
+      line = queuedCommands.front();
+      queuedCommands.pop_front();
+    }
+    const std::vector<std::string> words(splitWords(line));
+    if (words.empty())
+      continue;
+    // Steps are not run inside the running steps
+    if (stepsRunning && std::find(std::begin(STEPS_COMMANDS),
+                                  std::end(STEPS_COMMANDS),
+                                  words[0]) != std::end(STEPS_COMMANDS)) {
+      out << "Command \"" << words[0] << "\" cannot be run during steps."
+          << std::endl;
+      continue;
+    }
+    const std::vector<std::string> args(words.begin() + 1, words.end());
+    if (!executeCommand(words[0], args, out))
+      out << "Command \"" << words[0] << "\" not found." << std::endl;
+  }
+  return out.str();
+}
+
+bool GameManager::pollConsole() {
+  // Generations are scheduled by the clock, so time of steps does not slow
+  // them down, but missed generations are not caught up
+  const auto period =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(speed == 0 ? 0 : 1 / speed));
+  nextGenerationTime =
+      std::max(std::chrono::steady_clock::now(), nextGenerationTime + period);
+
+  // Keys are handled until the next generation without busy waiting
+  bool interrupted = false;
+  bool changed = false;
+  while (!interrupted) {
+    const InputResult result =
+        viewHandler.waitForInputUntil(nextGenerationTime);
+    if (result.isTimedOut())
+      break;
+    if (!result.isKeyboard())
+      continue;
+
+    changed = true;
+    const int key = result.getKey();
+    if (key == KEY_I && consoleInput.empty())
+      interrupted = true;
+    else if ((key == KEY_PLUS || key == KEY_EQUALS || key == KEY_MINUS) &&
+             consoleInput.empty())
+      changeSpeed(key != KEY_MINUS);
+    else if (key == KEY_ENTER) {
+      queueCommand(consoleInput);
+      consoleInput.clear();
+    } else if (key == KEY_BACKSPACE || key == KEY_DELETE) {
+      if (!consoleInput.empty())
+        consoleInput.pop_back();
+    } else if (key >= ' ' && key <= '~')
+      consoleInput += static_cast<char>(key);
+    if (std::chrono::steady_clock::now() >= nextGenerationTime)
+      break;
+  }
+
+  const std::string output(executeQueuedCommands(true));
+  if (!output.empty())
+    consoleOutput = output;
+  if (changed || !output.empty())
+    viewHandler.updateCommandLine(STEPS_PROMPT + " Speed: " +
+                                  describeSpeed(speed) + ".\n" +
+                                  consoleOutput + ">> " + consoleInput);
+  return interrupted;
+}
+
+void GameManager::setSpeed(double generationsPerSecond) {
+  speed = generationsPerSecond == 0
+              ? 0
+              : std::max(generationsPerSecond, MIN_SPEED);
+  nextGenerationTime = std::chrono::steady_clock::now();
+}
+
+double GameManager::getSpeed() const {
+  return speed;
+}
+
+void GameManager::changeSpeed(bool faster) {
+  if (faster)
+    setSpeed(speed == 0 || speed * 2 > MAX_LIMITED_SPEED ? 0 : speed * 2);
+  else
+    setSpeed(speed == 0 ? MAX_LIMITED_SPEED : std::max(speed / 2, MIN_SPEED));
+}
+
+bool GameManager::isRenderingSuppressed() const {
+  return scriptDepth != 0;
+}
+
 void GameManager::executionInCommandMode() {
   const std::string commandInput(viewHandler.readCommandInput());
   std::vector<std::string> split(splitString(commandInput));
@@ -436,6 +1489,15 @@ void GameManager::onKeyPressed(int key) {
     case KEY_C:
       executionInCommandMode();
       break;
+    case KEY_S:
+      setStatisticsShown(!statisticsShown);
+      break;
+    case KEY_PLUS:
+    case KEY_EQUALS:
+    case KEY_MINUS:
+      changeSpeed(key != KEY_MINUS);
+      viewHandler.updateCommandLine("Speed: " + describeSpeed(speed) + ".");
+      break;
     case KEY_ENTER:
       setCellAt(static_cast<int>(cursorX), static_cast<int>(cursorY));
       viewHandler.updateKeyboardCursor(cursorX, cursorY);
@@ -455,10 +1517,34 @@ bool GameManager::canCreateFieldWithSizes(size_t width, size_t height) const {
   return viewHandler.canCrateFieldWithSizes(width, height);
 }
 
-const GameField GameManager::getCurrentField() const {
+const GameField& GameManager::getCurrentField() const {
   return gameField;
 }
 
+size_t GameManager::getStepsCount() const {
+  return stepsCounter;
+}
+
+size_t GameManager::getPopulation() const {
+  return population;
+}
+
+size_t GameManager::getBirths() const {
+  return births;
+}
+
+size_t GameManager::getDeaths() const {
+  return deaths;
+}
+
+uint64_t GameManager::getFieldHash() const {
+  return fieldHash;
+}
+
+size_t GameManager::getPeriod() const {
+  return period;
+}
+
 size_t GameManager::getWidth() const {
   return width;
 }
@@ -470,3 +1556,15 @@ size_t GameManager::getHeight() const {
 ViewHandler& GameManager::getViewHandler() {
   return viewHandler;
 }
+
+void GameManager::setStatisticsShown(bool shown) {
+  statisticsShown = shown;
+  if (shown)
+    update();
+  else
+    viewHandler.clearStatistics();
+}
+
+bool GameManager::isStatisticsShown() const {
+  return statisticsShown;
+}
@@ -9,10 +9,17 @@
 #ifndef GAME_HANDLER_H
 #define GAME_HANDLER_H
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <istream>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "game_field.h"
 
@@ -69,6 +76,27 @@ class InputResult {
   int key;
 };
 
+class GameStatistics {
+ public:
+  // Steps made per second of wall time
+  double generationsPerSecond = 0;
+
+  // Duration of the last step computation without rendering
+  double stepMilliseconds = 0;
+
+  // Duration of the last field rendering
+  double renderMilliseconds = 0;
+
+  // Number of living cells
+  size_t population = 0;
+
+  // Number of field tiles, where cells changed on the last step
+  size_t activeTiles = 0;
+
+  // Memory used by fields of the game
+  size_t memoryBytes = 0;
+};
+
 class ViewHandler {
  public:
   /**
@@ -76,6 +104,16 @@ class ViewHandler {
    */
   virtual void updateField(const GameField& field, size_t stepsCount) = 0;
 
+  /**
+   * Draws performance statistics panel.
+   */
+  virtual void updateStatistics(const GameStatistics& statistics) {}
+
+  /**
+   * Hides performance statistics panel.
+   */
+  virtual void clearStatistics() {}
+
   /**
    * Draws keyboard cursor on field.
    */
@@ -102,6 +140,22 @@ class ViewHandler {
    */
   virtual const InputResult waitForInput(uint8_t timeout) = 0;
 
+  /**
+   * Waits for the key press/mouse click until the time point, returns the
+   * timeout event at once, if the time point has passed. By default waits
+   * with waitForInput() by tenths of a second.
+   */
+  virtual const InputResult waitForInputUntil(
+      std::chrono::steady_clock::time_point deadline) {
+    const std::chrono::milliseconds remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0)
+      return InputResult();
+    return waitForInput(static_cast<uint8_t>(
+        std::min<int64_t>(std::max<int64_t>(remaining.count() / 100, 1), 255)));
+  }
+
   /**
    * Checks whether it is possible to create a field with the given dimensions
    * on this terminal.
@@ -109,6 +163,39 @@ class ViewHandler {
   virtual bool canCrateFieldWithSizes(size_t width, size_t height) = 0;
 };
 
+/**
+ * View handler which draws nothing and never waits.
+ */
+class SilentViewHandler : public ViewHandler {
+ public:
+  void updateField(const GameField& field, size_t stepsCount) override {}
+
+  void updateKeyboardCursor(size_t posX, size_t posY) override {}
+
+  void updateCommandLine(const std::string& commandOutput) override {}
+
+  std::string readCommandInput() override { return ""; }
+
+  const InputResult waitForInput(uint8_t timeout) override {
+    return InputResult();
+  }
+
+  bool canCrateFieldWithSizes(size_t width, size_t height) override {
+    return true;
+  }
+};
+
+// Generations per second of running steps at start.
+const double DEFAULT_SPEED = 10;
+
+// Fastest speed of running steps with delays, faster steps are not delayed.
+const double MAX_LIMITED_SPEED = 1024;
+
+// Maximum period of oscillating generations, which can be detected.
+const size_t MAX_DETECTED_PERIOD = 256;
+
+class StepChanges;
+
 class GameManager {
  public:
   GameManager(size_t width, size_t height, ViewHandler& viewHandler);
@@ -118,7 +205,10 @@ class GameManager {
         height(field.getHeight()),
         gameField(field),
         previousStep(GameField(0, 0)),
-        viewHandler(viewHandler) {}
+        viewHandler(viewHandler) {
+    registerDefaultCommands();
+    recountFieldState();
+  }
 
   int runGame();
 
@@ -130,6 +220,58 @@ class GameManager {
    */
   bool setCellAt(int posX, int posY);
 
+  /**
+   * Places living cells of the pattern with its first cell at the position,
+   * the pattern is looped over the field edges. Cells under dead cells of the
+   * pattern are kept. Placing can be cancelled by stepBack().
+   * Throws std::invalid_argument, if the pattern is larger than the field.
+   */
+  void placePattern(const GameField& pattern, size_t posX, size_t posY);
+
+  /**
+   * Sets all cells of the region with the first cell at the position to life
+   * or death, the region is looped over the field edges. Can be cancelled by
+   * stepBack(). Throws std::invalid_argument, if the region is larger than
+   * the field.
+   */
+  void fillRegion(size_t posX,
+                  size_t posY,
+                  size_t regionWidth,
+                  size_t regionHeight,
+                  bool life);
+
+  /**
+   * Fills the region with randomly placed cells like fillRegion().
+   *
+   * @param density Probability of life in each cell.
+   * @param seed Random generator seed, the same seed gives the same cells.
+   */
+  void randomizeRegion(size_t posX,
+                       size_t posY,
+                       size_t regionWidth,
+                       size_t regionHeight,
+                       double density,
+                       uint64_t seed);
+
+  /**
+   * Copies cells of the region into the clipboard like fillRegion().
+   */
+  void copyRegion(size_t posX,
+                  size_t posY,
+                  size_t regionWidth,
+                  size_t regionHeight);
+
+  /**
+   * Replaces cells of the region at the position with the clipboard, dead
+   * cells of the clipboard are copied too. Can be cancelled by stepBack().
+   */
+  void pasteRegion(size_t posX, size_t posY);
+
+  /**
+   * @return Cells of the last copied region.
+   */
+  const GameField& getClipboard() const;
+
   /**
    * Clears the field, resets the steps counter and creates a field with new
    * dimensions.
@@ -141,8 +283,27 @@ class GameManager {
    */
   void reset(const GameField& field);
 
+  /**
+   * Sets new field without copying and resets the steps counter.
+   */
+  void reset(GameField&& field);
+
+  /**
+   * Changes the boundary rule of the field, periods are detected again.
+   */
+  void setBoundary(FieldBoundary boundary);
+
   void infiniteSteps();
 
+  /**
+   * If the current generation is periodic, skips the greatest number of steps
+   * not exceeding the given one, which is a multiple of the period. Field does
+   * not change, only the steps counter is increased.
+   *
+   * @return Number of skipped steps.
+   */
+  size_t fastForward(size_t steps);
+
   /**
    * Cancels last step.
    * You can cancel only one step.
@@ -161,20 +322,133 @@ class GameManager {
                                    GameManager&,
                                    std::ostream&));
 
+  /**
+   * Execute command by name.
+   * @param name Command name.
+   * @param args Command arguments.
+   *
+   * @return true, if command successfully executed.
+   */
+  bool executeCommand(const std::string& name,
+                      const std::vector<std::string>& args,
+                      std::ostream& output);
+
+  /**
+   * Executes commands from the script line by line. Fields are not drawn
+   * until the end of the script. Empty lines and lines starting with '#' are
+   * skipped.
+   *
+   * @return false, if some command is not found or throws, or scripts are
+   * nested too deeply. The rest of the script and of the scripts running it
+   * is skipped then.
+   */
+  bool runScript(std::istream& script, std::ostream& output);
+
+  /**
+   * Queues the command line, queued commands are executed between
+   * generations of running steps or after the current input event.
+   * Can be called from any thread.
+   */
+  void queueCommand(const std::string& line);
+
+  /**
+   * Executes queued command lines in the order of queueing.
+   *
+   * @param stepsRunning Commands are executed between running steps, so
+   * commands making steps are rejected.
+   *
+   * @return Output of the commands.
+   */
+  std::string executeQueuedCommands(bool stepsRunning = false);
+
+  /**
+   * Waits for input between generations of running steps. Typed keys edit
+   * the console line, which is queued by Enter, then queued commands are
+   * executed.
+   *
+   * @return true, if steps are interrupted by I with the empty console line.
+   */
+  bool pollConsole();
+
+  /**
+   * Sets number of generations per second of running steps, zero for steps
+   * without delay. Slower speeds are raised to the slowest supported one.
+   */
+  void setSpeed(double generationsPerSecond);
+
+  /**
+   * @return Generations per second of running steps, zero for steps without
+   * delay.
+   */
+  double getSpeed() const;
+
+  /**
+   * Doubles speed of running steps or halves it, the fastest limited speed
+   * is followed by steps without delay.
+   */
+  void changeSpeed(bool faster);
+
+  /**
+   * @return true, if fields are not drawn and steps are not delayed, for
+   * example during scripts.
+   */
+  bool isRenderingSuppressed() const;
+
   /**
    * Checks whether it is possible to create a field with the given dimensions
    * on this terminal.
    */
   bool canCreateFieldWithSizes(size_t fieldWidth, size_t fieldHeight) const;
 
-  const GameField getCurrentField() const;
+  /**
+   * @return Current field without copying, it is changed by the next steps
+   * and edits.
+   */
+  const GameField& getCurrentField() const;
 
   size_t getWidth() const;
 
   size_t getHeight() const;
 
+  size_t getStepsCount() const;
+
+  /**
+   * @return Number of living cells on the field.
+   */
+  size_t getPopulation() const;
+
+  /**
+   * @return Number of cells born on the last step.
+   */
+  size_t getBirths() const;
+
+  /**
+   * @return Number of cells died on the last step.
+   */
+  size_t getDeaths() const;
+
+  /**
+   * @return Hash of the current field, which is updated incrementally by
+   * changes of cells.
+   */
+  uint64_t getFieldHash() const;
+
+  /**
+   * Returns the period, after which the current generation repeats itself.
+   * 1 for still lifes, 0 if the generation did not repeat any of the last
+   * MAX_DETECTED_PERIOD generations.
+   */
+  size_t getPeriod() const;
+
   ViewHandler& getViewHandler();
 
+  /**
+   * Shows or hides performance statistics panel.
+   */
+  void setStatisticsShown(bool shown);
+
+  bool isStatisticsShown() const;
+
  private:
   size_t width;
   size_t height;
@@ -187,21 +461,153 @@ class GameManager {
   GameField gameField;
   GameField previousStep;
 
+  // Region copied by copyRegion()
+  GameField clipboard = GameField(0, 0);
+
   ViewHandler& viewHandler;
 
   size_t stepsCounter = 0;
   bool hasUndo = false;  // Is it possible to cancel at this step
 
+  // Words changed by the last edit with their old values, as offsets from the
+  // first row, so the edit is cancelled without the copy of the whole field
+  std::vector<std::pair<size_t, uint64_t>> editedWords;
+  bool undoEdit = false;
+
+  // Number of living cells on the field and before the last change
+  size_t population = 0;
+  size_t previousPopulation = 0;
+
+  // Changes made by the last step
+  size_t births = 0;
+  size_t deaths = 0;
+
+  // Hash of the current field and before the last change
+  uint64_t fieldHash = 0;
+  uint64_t previousHash = 0;
+
+  // Hashes of the last generations in a ring buffer
+  std::vector<uint64_t> hashHistory;
+  size_t hashHistoryNext = 0;
+
+  // Detected period of the current generation
+  size_t period = 0;
+
+  // Tiles of the field, where cells changed on the last step, one byte per
+  // tile, so bands of rows can mark them from different threads
+  std::vector<uint8_t> changedTiles;
+  size_t activeTiles = 0;
+
+  // Command lines waiting for execution, guarded by the mutex
+  std::deque<std::string> queuedCommands;
+  std::mutex queueMutex;
+
+  // Generations per second of running steps, zero without delay
+  double speed = DEFAULT_SPEED;
+
+  // Time of the next generation of running steps
+  std::chrono::steady_clock::time_point nextGenerationTime =
+      std::chrono::steady_clock::now();
+
+  // Line typed during running steps and output of its commands
+  std::string consoleInput;
+  std::string consoleOutput;
+
+  // Number of scripts being executed, one inside another
+  size_t scriptDepth = 0;
+  // Some command of the running scripts failed, all of them are stopped
+  bool scriptFailed = false;
+
+  GameStatistics statistics;
+  bool statisticsShown = false;
+
+  // Steps counted since the generation rate measure start
+  size_t rateSteps = 0;
+  std::chrono::steady_clock::time_point rateStart =
+      std::chrono::steady_clock::now();
+
   // Keyboard cursor on field position
   size_t cursorX = 0;
   size_t cursorY = 0;
 
   /**
-   * Counts the number of living cells around this cell.
+   * Registers built-in command handlers.
+   */
+  void registerDefaultCommands();
+
+  /**
+   * Counts living cells and hash of the current field.
+   */
+  void recountFieldState();
+
+  /**
+   * Looks for the current field hash in the history and remembers it.
+   */
+  void detectPeriod();
+
+  /**
+   * Adds hash to the ring buffer of generation hashes.
+   */
+  void rememberHash(uint64_t hash);
+
+  /**
+   * Forgets generation hashes, for example after the field was edited.
+   */
+  void resetHistory();
+
+  /**
+   * Starts the edit of cells, which is cancelled by the edited words.
+   */
+  void beginEdit();
+
+  /**
+   * Writes cells of the region to the field at the position, looping over
+   * the field edges. Throws std::invalid_argument, if the region is larger
+   * than the field.
+   *
+   * @param onlyLiving If true, cells under dead cells of the region are kept.
+   */
+  void writeRegion(const GameField& region,
+                   size_t posX,
+                   size_t posY,
+                   bool onlyLiving);
+
+  /**
+   * Sets cells of the row under the mask starting from the position to the
+   * given ones, cells after the row end are continued from its beginning.
+   * Population, hash and the edited words are updated.
+   *
+   * @param count Number of cells, not more than 64 and the row length.
+   */
+  void editRowCells(size_t posX,
+                    size_t posY,
+                    uint64_t cells,
+                    uint64_t mask,
+                    size_t count);
+
+  /**
+   * Sets cells of the row word under the mask to the given ones.
+   */
+  void editWord(size_t posX, size_t word, uint64_t cells, uint64_t mask);
+
+  /**
+   * Marks the tile of the cell as changed.
    *
-   * @return Number of living cells around
+   * @return true, if the tile was not marked before.
+   */
+  bool markTileChanged(size_t posX, size_t posY);
+
+  /**
+   * Computes the next generation of rows in range [begin, end) from the
+   * previous step with refreshed ghost cells. Ranges, which start at tile
+   * boundaries, may be stepped in parallel.
+   */
+  void stepRows(size_t begin, size_t end, StepChanges& changes);
+
+  /**
+   * Updates steps per second measure after step is made.
    */
-  size_t countLifeAround(int posX, int posY) const;
+  void updateGenerationRate();
 
   /**
    * Forces the update view handler without making any changes to the state of
@@ -215,17 +621,6 @@ class GameManager {
    */
   void executionInCommandMode();
 
-  /**
-   * Execute command by name.
-   * @param name Command name.
-   * @param args Command arguments.
-   *
-   * @return true, if command successfully executed.
-   */
-  bool executeCommand(const std::string& name,
-                      const std::vector<std::string>& args,
-                      std::ostream& output);
-
   /**
    * Catch mouse clicks.
    */
@@ -6,15 +6,115 @@
 //  Copyright © 2017 Кирилл. All rights reserved.
 //
 
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "band_workers.h"
+#include "field_pool.h"
 #include "game_handler.h"
+#include "pattern_library.h"
+#include "profiler.h"
+#include "soup_search.h"
 #include "view_handler.h"
 
 // Size of standart field
 const size_t FIELD_WIDTH = 10;
 const size_t FIELD_HEIGHT = 10;
 
+// Directory of RLE patterns loaded at start, if it exists
+const std::string DEFAULT_PATTERNS_DIRECTORY = "patterns";
+
 int main(int argc, const char* argv[]) {
-  CursesViewHandler view;
-  GameManager control(FIELD_WIDTH, FIELD_HEIGHT, view);
-  return control.runGame();
+  // File for profiling statistics at exit
+  std::string profileFilename;
+
+  // Headless soup search options
+  size_t soups = 0;
+  uint64_t seed = 0;
+  size_t threads = 0;
+  size_t width = FIELD_WIDTH;
+  size_t height = FIELD_HEIGHT;
+
+  // Random initial field, if density is not negative
+  double density = -1;
+
+  std::string patternsDirectory = DEFAULT_PATTERNS_DIRECTORY;
+
+  // Script executed without terminal UI
+  std::string scriptFilename;
+
+  // Memory and threads of large fields
+  const std::string hugePagesNames[] = {"none", "transparent", "reserved"};
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if (arg == "--profile" && i + 1 < argc)
+      profileFilename = argv[++i];
+    else if (arg == "--soup" && i + 1 < argc)
+      soups = std::strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && i + 1 < argc)
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    else if (arg == "--threads" && i + 1 < argc)
+      threads = std::strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--random" && i + 1 < argc) {
+      density = std::strtod(argv[++i], nullptr);
+      if (!std::isfinite(density)) {
+        std::cerr << "Density must be a finite number" << std::endl;
+        return -1;
+      }
+    } else if (arg == "--script" && i + 1 < argc)
+      scriptFilename = argv[++i];
+    else if (arg == "--patterns" && i + 1 < argc)
+      patternsDirectory = argv[++i];
+    else if (arg == "--step-threads" && i + 1 < argc)
+      BandWorkers::getInstance().setThreads(
+          std::strtoul(argv[++i], nullptr, 10));
+    else if (arg == "--huge-pages" && i + 1 < argc) {
+      const std::string name(argv[++i]);
+      int pages = HUGE_PAGES_NONE;
+      while (pages <= HUGE_PAGES_RESERVED && hugePagesNames[pages] != name)
+        pages++;
+      if (pages > HUGE_PAGES_RESERVED) {
+        std::cerr << "Unknown huge pages \"" << name
+                  << "\", need: none, transparent or reserved" << std::endl;
+        return -1;
+      }
+      FieldBufferPool::setHugePages(static_cast<HugePages>(pages));
+    } else if (arg == "--size" && i + 2 < argc) {
+      width = std::strtoul(argv[++i], nullptr, 10);
+      height = std::strtoul(argv[++i], nullptr, 10);
+    }
+  }
+
+  PatternLibrary::getInstance().loadDirectory(patternsDirectory, std::cerr);
+
+  int result = 0;
+  if (soups != 0)
+    std::cout << SoupSearch(width, height).run(soups, seed, threads);
+  else if (!scriptFilename.empty()) {
+    std::ifstream script(scriptFilename);
+    if (!script.is_open()) {
+      std::cerr << "Cannot load file \"" << scriptFilename << "\"" << std::endl;
+      return -1;
+    }
+    SilentViewHandler view;
+    GameManager control(width, height, view);
+    if (density >= 0)
+      control.reset(GameField::createRandom(width, height, density, seed));
+    result = control.runScript(script, std::cout) ? 0 : -1;
+  } else {
+    CursesViewHandler view;
+    GameManager control(width, height, view);
+    if (density >= 0)
+      control.reset(GameField::createRandom(width, height, density, seed));
+    result = control.runGame();
+  }
+
+  if (!profileFilename.empty()) {
+    std::ofstream file(profileFilename);
+    Profiler::getInstance().writeJson(file);
+  }
+  return result;
 }
@@ -0,0 +1,382 @@
+//
+//  pattern_library.cpp
+//  GameOfLive
+//
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#include "band_workers.h"
+#include "pattern_library.h"
+
+// Well-known patterns in the RLE format.
+static const std::pair<const char*, const char*> BUILT_IN_PATTERNS[] = {
+    {"block", "x = 2, y = 2\n2o$2o!"},
+    {"blinker", "x = 3, y = 1\n3o!"},
+    {"glider", "x = 3, y = 3\nbo$2bo$3o!"},
+    {"lwss", "x = 5, y = 4\nbo2bo$o$o3bo$4o!"},
+    {"mwss", "x = 6, y = 5\n3bo$bo3bo$o$o4bo$5o!"},
+    {"hwss", "x = 7, y = 5\n3b2o$bo4bo$o$o5bo$6o!"},
+    {"r-pentomino", "x = 3, y = 3\nb2o$2o$bo!"},
+    {"acorn", "x = 7, y = 3\nbo$3bo$2o2b3o!"},
+    {"diehard", "x = 8, y = 3\n6bo$2o$bo3b3o!"},
+    {"pulsar",
+     "x = 13, y = 13\n2b3o3b3o2$o4bobo4bo$o4bobo4bo$o4bobo4bo$2b3o3b3o2$"
+     "2b3o3b3o$o4bobo4bo$o4bobo4bo$o4bobo4bo2$2b3o3b3o!"},
+    {"gosper-gun",
+     "x = 36, y = 9\n24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$"
+     "2o8bo5bo3b2o$2o8bo3bob2o4bobo$10bo5bo7bo$11bo3bo$12b2o!"},
+};
+
+// Patterns are limited by side and by number of cells, so damaged headers
+// are reported before the field is allocated.
+static const size_t MAX_PATTERN_SIDE = 1 << 20;
+static const size_t MAX_PATTERN_CELLS = size_t(1) << 32;
+
+/**
+ * Reads the size from the RLE header like "x = 3, y = 3, rule = B3/S23".
+ *
+ * @param name Name of the size, 'x' or 'y'.
+ */
+static size_t readHeaderSize(const std::string& header,
+                             char name,
+                             size_t line) {
+  for (size_t i = 0; i < header.size(); i++) {
+    if (header[i] != name ||
+        (i != 0 && header[i - 1] != ' ' && header[i - 1] != ','))
+      continue;
+    size_t pos = header.find_first_not_of(' ', i + 1);
+    if (pos == std::string::npos || header[pos] != '=')
+      continue;
+    pos = header.find_first_not_of(' ', pos + 1);
+    if (pos == std::string::npos || !std::isdigit(header[pos]))
+      throw BadGameFieldException(line, pos, "Invalid pattern size");
+    errno = 0;
+    const unsigned long long size =
+        std::strtoull(header.c_str() + pos, nullptr, 10);
+    if (errno == ERANGE || size > MAX_PATTERN_SIDE)
+      throw BadGameFieldException(line, pos, "Pattern size is too large");
+    return size;
+  }
+  throw BadGameFieldException(line, 0, "No pattern size in the header");
+}
+
+/**
+ * Sets the run of cells of the packed row by words.
+ *
+ * @param shared Row may be set by other threads, words are set atomically.
+ */
+static void setCellsRun(uint64_t* row,
+                        size_t begin,
+                        size_t count,
+                        bool shared) {
+  while (count != 0) {
+    const size_t bit = begin % 64;
+    const size_t cells = std::min(count, 64 - bit);
+    const uint64_t mask =
+        cells == 64 ? ~uint64_t(0) : (uint64_t(1) << cells) - 1;
+    if (shared)
+      __atomic_fetch_or(&row[begin / 64], mask << bit, __ATOMIC_RELAXED);
+    else
+      row[begin / 64] |= mask << bit;
+    begin += cells;
+    count -= cells;
+  }
+}
+
+/**
+ * Chunk of the pattern runs. Chunks are parsed in parallel: moves of each
+ * chunk are summed first to find, where the next one starts, then cells of
+ * the runs are set.
+ */
+struct RunsChunk {
+  size_t begin = 0;
+  size_t end = 0;
+
+  // Moves of the chunk: line breaks, rows skipped by '$' and cells after
+  // the last '$'
+  size_t lines = 0;
+  size_t rows = 0;
+  size_t cells = 0;
+  bool newRow = false;
+  // Pattern ends with '!' in the chunk
+  bool last = false;
+
+  // Line, row and cell, where the chunk starts
+  size_t line = 0;
+  size_t posX = 0;
+  size_t posY = 0;
+};
+
+/**
+ * @return Position of the first run at the position or after it, so counts
+ * of runs are not split between chunks.
+ */
+static size_t findRunStart(const std::string& str, size_t begin, size_t pos) {
+  while (pos > begin && pos < str.size() &&
+         (std::isdigit(str[pos - 1]) || std::isspace(str[pos - 1])))
+    pos++;
+  return pos;
+}
+
+/**
+ * Sums moves of the chunk. Runs are limited by the field sizes like in
+ * parseRuns, so sums do not overflow.
+ */
+static void sumRuns(const std::string& str,
+                    RunsChunk& chunk,
+                    size_t rows,
+                    size_t rowLength) {
+  chunk.lines =
+      std::count(str.begin() + chunk.begin, str.begin() + chunk.end, '\n');
+  size_t count = 0;
+  for (size_t pos = chunk.begin; pos < chunk.end; pos++) {
+    const char symbol = str[pos];
+    if (std::isdigit(symbol)) {
+      count = count * 10 + (symbol - '0');
+      continue;
+    } else if (std::isspace(symbol))
+      continue;
+
+    const size_t run = count == 0 ? 1 : count;
+    count = 0;
+    if (symbol == '$') {
+      chunk.rows += std::min(run, rows);
+      chunk.cells = 0;
+      chunk.newRow = true;
+    } else if (symbol == '!') {
+      chunk.last = true;
+      return;
+    } else
+      chunk.cells += std::min(run, rowLength);
+  }
+}
+
+/**
+ * @return Error at the position of the chunk with the line and the position
+ * in the line.
+ */
+static BadGameFieldException getRunsError(const std::string& str,
+                                          const RunsChunk& chunk,
+                                          size_t pos,
+                                          const std::string& reason) {
+  const size_t line =
+      chunk.line +
+      std::count(str.begin() + chunk.begin, str.begin() + pos, '\n');
+  // Runs always follow the header line
+  return BadGameFieldException(line, pos - str.rfind('\n', pos) - 1, reason);
+}
+
+/**
+ * Sets cells of the chunk runs. Edge rows of the chunk may be continued by
+ * the neighbour chunks, they are set atomically.
+ */
+static void parseRuns(const std::string& str,
+                      const RunsChunk& chunk,
+                      GameField& field) {
+  const size_t rows = field.getWidth();
+  const size_t rowLength = field.getHeight();
+  // Chunk is copied to locals, stores of cells may alias its fields
+  const char* text = str.data();
+  const size_t end = chunk.end;
+  const size_t firstRow = chunk.posX;
+  const size_t lastRow = chunk.posX + chunk.rows;
+  size_t posX = chunk.posX;
+  size_t posY = chunk.posY;
+  size_t count = 0;
+  for (size_t pos = chunk.begin; pos < end; pos++) {
+    const char symbol = text[pos];
+    if (std::isdigit(symbol)) {
+      count = count * 10 + (symbol - '0');
+      continue;
+    } else if (std::isspace(symbol))
+      continue;
+
+    const size_t run = count == 0 ? 1 : count;
+    count = 0;
+    switch (symbol) {
+      case 'b':
+        posY += std::min(run, rowLength - std::min(posY, rowLength));
+        break;
+      case 'o':
+        if (posX >= rows || run > rowLength - std::min(posY, rowLength))
+          throw getRunsError(str, chunk, pos,
+                             "Pattern exceeds the header size");
+        setCellsRun(field.getRow(posX), posY, run,
+                    posX == firstRow || posX == lastRow);
+        posY += run;
+        break;
+      case '$':
+        posX += std::min(run, rows);
+        posY = 0;
+        break;
+      case '!':
+        return;
+      default:
+        throw getRunsError(str, chunk, pos, "Unknown cell state");
+    }
+  }
+}
+
+GameField parseRle(const std::string& str) {
+  // Comments and empty lines before the header
+  std::string header;
+  size_t begin = 0;
+  size_t line = 0;
+  while (true) {
+    if (begin >= str.size())
+      throw BadGameFieldException(line, 0, "No pattern header");
+    const size_t end = std::min(str.find('\n', begin), str.size());
+    header = str.substr(begin, end - begin);
+    begin = std::min(end + 1, str.size());
+    if (!header.empty() && header[0] != '#' && header != "\r")
+      break;
+    line++;
+  }
+  const size_t rows = readHeaderSize(header, 'y', line);
+  const size_t rowLength = readHeaderSize(header, 'x', line);
+  if (rows * rowLength > MAX_PATTERN_CELLS)
+    throw BadGameFieldException(line, 0, "Pattern size is too large");
+  GameField field(rows, rowLength);
+
+  // Runs start at the line after the header
+  const size_t size = str.size() - begin;
+  const size_t textWords = size / sizeof(uint64_t);
+  BandWorkers& workers = BandWorkers::getInstance();
+  if (workers.getBandsCount(textWords) <= 1) {
+    // Single chunk is parsed without summing its moves
+    RunsChunk chunk;
+    chunk.begin = begin;
+    chunk.end = str.size();
+    chunk.line = line + 1;
+    parseRuns(str, chunk, field);
+    return field;
+  }
+
+  // Runs are split into chunks, which are summed in parallel
+  const size_t threads = workers.getThreads();
+  std::vector<RunsChunk> chunks(threads);
+  size_t chunksCount = 0;
+  runInBands(size, 1, textWords, [&](size_t chunk, size_t from, size_t to) {
+    chunks[chunk].begin = findRunStart(str, begin, begin + from);
+    chunks[chunk].end = findRunStart(str, begin, begin + to);
+    sumRuns(str, chunks[chunk], rows, rowLength);
+    if (to == size)
+      chunksCount = chunk + 1;
+  });
+
+  // Each chunk starts, where the previous one ends
+  chunks[0].line = line + 1;
+  for (size_t i = 1; i < chunksCount; i++) {
+    const RunsChunk& previous = chunks[i - 1];
+    if (previous.last) {
+      chunksCount = i;
+      break;
+    }
+    chunks[i].line = previous.line + previous.lines;
+    chunks[i].posX = previous.posX + previous.rows;
+    chunks[i].posY =
+        std::min(previous.newRow ? previous.cells
+                                 : previous.posY + previous.cells,
+                 rowLength);
+  }
+
+  // The first error in the pattern order is reported
+  std::vector<std::exception_ptr> errors(threads);
+  runInBands(size, 1, textWords, [&](size_t chunk, size_t from, size_t to) {
+    if (chunk >= chunksCount)
+      return;
+    try {
+      parseRuns(str, chunks[chunk], field);
+    } catch (const BadGameFieldException&) {
+      errors[chunk] = std::current_exception();
+    }
+  });
+  for (const std::exception_ptr& error : errors)
+    if (error)
+      std::rethrow_exception(error);
+  return field;
+}
+
+Pattern::Pattern(const GameField& cells) {
+  rotations.push_back(cells);
+  for (size_t turn = 1; turn < 4; turn++) {
+    const GameField& source = rotations.back();
+    const size_t rows = source.getWidth();
+    GameField rotated(source.getHeight(), rows);
+    // Row of the rotated pattern is the column of the source read upwards
+    for (size_t i = 0; i < rows; i++)
+      for (size_t j = 0; j < source.getHeight(); j++)
+        if (source.isLifeAt(i, j))
+          rotated.setLifeAt(j, rows - 1 - i, true);
+    rotations.push_back(std::move(rotated));
+  }
+}
+
+const GameField& Pattern::getRotation(size_t quarterTurns) const {
+  return rotations[quarterTurns % rotations.size()];
+}
+
+PatternLibrary& PatternLibrary::getInstance() {
+  static PatternLibrary library;
+  return library;
+}
+
+PatternLibrary::PatternLibrary() {
+  for (auto pattern : BUILT_IN_PATTERNS)
+    add(pattern.first, parseRle(pattern.second));
+}
+
+void PatternLibrary::add(const std::string& name, const GameField& cells) {
+  patterns.erase(name);
+  patterns.insert(std::make_pair(name, Pattern(cells)));
+}
+
+size_t PatternLibrary::loadDirectory(const std::string& path,
+                                     std::ostream& errors) {
+  DIR* directory = opendir(path.c_str());
+  if (directory == nullptr)
+    return 0;
+
+  size_t loaded = 0;
+  while (const dirent* entry = readdir(directory)) {
+    const std::string filename(entry->d_name);
+    if (filename.size() <= RLE_EXTENSION.size() ||
+        filename.compare(filename.size() - RLE_EXTENSION.size(),
+                         RLE_EXTENSION.size(), RLE_EXTENSION) != 0)
+      continue;
+
+    std::ifstream file(path + "/" + filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    try {
+      add(filename.substr(0, filename.size() - RLE_EXTENSION.size()),
+          parseRle(content.str()));
+      loaded++;
+    } catch (const BadGameFieldException& e) {
+      errors << "Cannot load pattern \"" << filename << "\": " << e.what()
+             << std::endl;
+    }
+  }
+  closedir(directory);
+  return loaded;
+}
+
+const Pattern* PatternLibrary::find(const std::string& name) const {
+  auto pattern = patterns.find(name);
+  return pattern == patterns.end() ? nullptr : &pattern->second;
+}
+
+std::vector<std::string> PatternLibrary::getNames() const {
+  std::vector<std::string> names;
+  for (auto& pattern : patterns)
+    names.push_back(pattern.first);
+  return names;
+}
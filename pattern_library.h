@@ -0,0 +1,87 @@
+//
+//  pattern_library.h
+//  GameOfLive
+//
+
+#ifndef PATTERN_LIBRARY_H
+#define PATTERN_LIBRARY_H
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "game_field.h"
+
+// Extension of pattern files in the run length encoded format.
+const std::string RLE_EXTENSION = ".rle";
+
+/**
+ * Parses the pattern in the run length encoded (RLE) format.
+ * Lines of the pattern become rows of the field, like lines of the text
+ * format. Comment lines start with '#', the header "x = <row length>,
+ * y = <rows>" is required, the rule is not checked.
+ * Throws BadGameFieldException, if the pattern is damaged, does not fit
+ * the header sizes or the sizes are too large.
+ */
+GameField parseRle(const std::string& str);
+
+/**
+ * Pattern with its rotations packed like fields, so it is placed by words.
+ */
+class Pattern {
+ public:
+  Pattern(const GameField& cells);
+
+  /**
+   * @return Pattern rotated clockwise in the text format by the given number
+   * of quarter turns.
+   */
+  const GameField& getRotation(size_t quarterTurns) const;
+
+ private:
+  std::vector<GameField> rotations;
+};
+
+/**
+ * Named patterns for placing on the field. Well-known patterns are built in,
+ * more are loaded from directories of RLE files.
+ */
+class PatternLibrary {
+ public:
+  static PatternLibrary& getInstance();
+
+  /**
+   * Adds the pattern, pattern with the same name is replaced.
+   */
+  void add(const std::string& name, const GameField& cells);
+
+  /**
+   * Loads every RLE file of the directory, the file name without extension
+   * becomes the pattern name. Damaged files are skipped with a message.
+   *
+   * @return Number of loaded patterns, or zero, if there is no directory.
+   */
+  size_t loadDirectory(const std::string& path, std::ostream& errors);
+
+  /**
+   * @return Pattern by name or nullptr, if there is no such pattern.
+   */
+  const Pattern* find(const std::string& name) const;
+
+  /**
+   * @return Sorted names of all patterns.
+   */
+  std::vector<std::string> getNames() const;
+
+ private:
+  std::map<std::string, Pattern> patterns;
+
+  PatternLibrary();
+
+  PatternLibrary(const PatternLibrary&) = delete;
+
+  PatternLibrary& operator=(const PatternLibrary&) = delete;
+};
+
+#endif /* PATTERN_LIBRARY_H */
@@ -0,0 +1,114 @@
+//
+//  profiler.cpp
+//  GameOfLive
+//
+
+#include "profiler.h"
+
+static const char* PHASE_NAMES[PROFILE_PHASES_COUNT] = {
+    "step", "render", "save", "load", "command"};
+
+static const char* COUNTER_NAMES[COUNTERS_COUNT] = {
+    "steps",    "renders",  "bytes_saved", "bytes_loaded",
+    "commands", "unknown_commands", "buffers_allocated", "buffers_reused"};
+
+/**
+ * @return Index of the power of two bucket for the latency.
+ */
+static size_t getBucket(uint64_t nanoseconds) {
+  size_t bucket = 0;
+  while (nanoseconds != 0 && bucket + 1 < PROFILE_BUCKETS) {
+    nanoseconds >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+Profiler& Profiler::getInstance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler() {
+  reset();
+}
+
+void Profiler::record(ProfilePhase phase, uint64_t nanoseconds) {
+  Histogram& histogram = phases[phase];
+  histogram.count.fetch_add(1, std::memory_order_relaxed);
+  histogram.total.fetch_add(nanoseconds, std::memory_order_relaxed);
+  histogram.buckets[getBucket(nanoseconds)].fetch_add(
+      1, std::memory_order_relaxed);
+
+  uint64_t max = histogram.max.load(std::memory_order_relaxed);
+  while (nanoseconds > max &&
+         !histogram.max.compare_exchange_weak(max, nanoseconds,
+                                              std::memory_order_relaxed))
+    ;
+}
+
+void Profiler::count(ProfileCounter counter, uint64_t value) {
+  counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Profiler::reset() {
+  for (Histogram& histogram : phases) {
+    histogram.count = 0;
+    histogram.total = 0;
+    histogram.max = 0;
+    for (auto& bucket : histogram.buckets)
+      bucket = 0;
+  }
+  for (auto& counter : counters)
+    counter = 0;
+}
+
+uint64_t Profiler::Histogram::getPercentile(double part) const {
+  uint64_t records = count.load(std::memory_order_relaxed);
+  uint64_t passed = 0;
+  for (size_t i = 0; i < PROFILE_BUCKETS; i++) {
+    passed += buckets[i].load(std::memory_order_relaxed);
+    if (passed != 0 && passed >= part * records)
+      return i == 0 ? 0 : uint64_t(1) << i;
+  }
+  return max.load(std::memory_order_relaxed);
+}
+
+void Profiler::writeText(std::ostream& out) const {
+  for (size_t i = 0; i < PROFILE_PHASES_COUNT; i++) {
+    const Histogram& histogram = phases[i];
+    uint64_t count = histogram.count.load(std::memory_order_relaxed);
+    if (count == 0)
+      continue;
+    out << PHASE_NAMES[i] << ": n=" << count
+        << " avg=" << histogram.total / 1000.0 / count
+        << "us p50<" << histogram.getPercentile(0.5) / 1000.0
+        << "us p99<" << histogram.getPercentile(0.99) / 1000.0
+        << "us max=" << histogram.max / 1000.0 << "us" << std::endl;
+  }
+  for (size_t i = 0; i < COUNTERS_COUNT; i++)
+    out << COUNTER_NAMES[i] << "=" << counters[i] << " ";
+  out << std::endl;
+}
+
+void Profiler::writeJson(std::ostream& out) const {
+  out << "{\n  \"phases\": {";
+  for (size_t i = 0; i < PROFILE_PHASES_COUNT; i++) {
+    const Histogram& histogram = phases[i];
+    out << (i == 0 ? "" : ",") << "\n    \"" << PHASE_NAMES[i] << "\": {"
+        << "\"count\": " << histogram.count
+        << ", \"total_ns\": " << histogram.total
+        << ", \"max_ns\": " << histogram.max
+        << ", \"p50_ns\": " << histogram.getPercentile(0.5)
+        << ", \"p99_ns\": " << histogram.getPercentile(0.99)
+        << ", \"buckets\": [";
+    for (size_t j = 0; j < PROFILE_BUCKETS; j++)
+      out << (j == 0 ? "" : ", ") << histogram.buckets[j];
+    out << "]}";
+  }
+  out << "\n  },\n  \"counters\": {";
+  for (size_t i = 0; i < COUNTERS_COUNT; i++)
+    out << (i == 0 ? "" : ",") << "\n    \"" << COUNTER_NAMES[i]
+        << "\": " << counters[i];
+  out << "\n  }\n}" << std::endl;
+}
@@ -0,0 +1,117 @@
+//
+//  profiler.h
+//  GameOfLive
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Number of power of two latency buckets in nanoseconds.
+const size_t PROFILE_BUCKETS = 48;
+
+enum ProfilePhase {
+  PROFILE_STEP,
+  PROFILE_RENDER,
+  PROFILE_SAVE,
+  PROFILE_LOAD,
+  PROFILE_COMMAND,
+  PROFILE_PHASES_COUNT
+};
+
+enum ProfileCounter {
+  COUNTER_STEPS,
+  COUNTER_RENDERS,
+  COUNTER_BYTES_SAVED,
+  COUNTER_BYTES_LOADED,
+  COUNTER_COMMANDS,
+  COUNTER_UNKNOWN_COMMANDS,
+  COUNTER_BUFFERS_ALLOCATED,
+  COUNTER_BUFFERS_REUSED,
+  COUNTERS_COUNT
+};
+
+/**
+ * Collects latency histograms of the hot phases and event counters.
+ * Recording is lock-free and may be done from any thread.
+ */
+class Profiler {
+ public:
+  static Profiler& getInstance();
+
+  void record(ProfilePhase phase, uint64_t nanoseconds);
+
+  void count(ProfileCounter counter, uint64_t value = 1);
+
+  void reset();
+
+  /**
+   * Writes short human readable summary, one line per phase.
+   */
+  void writeText(std::ostream& out) const;
+
+  void writeJson(std::ostream& out) const;
+
+ private:
+  class Histogram {
+   public:
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> buckets[PROFILE_BUCKETS];
+
+    /**
+     * @return Upper bound of the latency in nanoseconds, which is not exceeded
+     * by the given part of records.
+     */
+    uint64_t getPercentile(double part) const;
+  };
+
+  Histogram phases[PROFILE_PHASES_COUNT];
+  std::atomic<uint64_t> counters[COUNTERS_COUNT];
+
+  Profiler();
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+};
+
+/**
+ * Records time from creation to destruction into profiler phase.
+ */
+class ProfileTimer {
+ public:
+  ProfileTimer(ProfilePhase phase)
+      : phase(phase), start(std::chrono::steady_clock::now()) {}
+
+  ~ProfileTimer() {
+    std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+    Profiler::getInstance().record(phase, time.count());
+  }
+
+ private:
+  const ProfilePhase phase;
+  const std::chrono::steady_clock::time_point start;
+};
+
+// Instrumentation is removed completely, if PROFILING is not defined.
+#ifdef PROFILING
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(phase) \
+  ProfileTimer PROFILE_CONCAT(profileTimer, __LINE__)(phase)
+#define PROFILE_RECORD(phase, nanoseconds) \
+  Profiler::getInstance().record(phase, nanoseconds)
+#define PROFILE_COUNT(counter, value) \
+  Profiler::getInstance().count(counter, value)
+#else
+#define PROFILE_SCOPE(phase)
+#define PROFILE_RECORD(phase, nanoseconds)
+#define PROFILE_COUNT(counter, value)
+#endif
+
+#endif /* PROFILER_H */
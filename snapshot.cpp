@@ -0,0 +1,241 @@
+//
+//  snapshot.cpp
+//  GameOfLive
+//
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "band_workers.h"
+#include "snapshot.h"
+
+static const char SNAPSHOT_MAGIC[8] = {'G', 'O', 'L', 'S', 'N', 'A', 'P', '1'};
+
+// Header fields after the magic: width, height, boundary, tiles count.
+static const size_t HEADER_FIELDS = 4;
+
+// Sides of fields in snapshots are limited to not overflow sizes of buffers.
+static const uint64_t MAX_SNAPSHOT_SIDE = uint64_t(1) << 32;
+
+// Snapshot is read by blocks of this size.
+static const size_t READ_BLOCK_SIZE = 1 << 24;
+
+static void putWord(std::string& out, uint64_t word) {
+  for (size_t i = 0; i < 8; i++)
+    out += static_cast<char>(word >> (i * 8));
+}
+
+static void putNumber(std::string& out, uint64_t number) {
+  while (number >= 0x80) {
+    out += static_cast<char>(number | 0x80);
+    number >>= 7;
+  }
+  out += static_cast<char>(number);
+}
+
+/**
+ * Reader of the snapshot bytes with bounds checks.
+ */
+class SnapshotReader {
+ public:
+  SnapshotReader(const char* data, size_t size) : data(data), size(size) {}
+
+  uint64_t getWord() {
+    if (size - pos < 8)
+      throw std::runtime_error("Snapshot is truncated");
+    uint64_t word = 0;
+    for (size_t i = 0; i < 8; i++)
+      word |= uint64_t(static_cast<uint8_t>(data[pos++])) << (i * 8);
+    return word;
+  }
+
+  uint64_t getNumber() {
+    uint64_t number = 0;
+    for (size_t shift = 0; shift < 64; shift += 7) {
+      if (pos == size)
+        throw std::runtime_error("Snapshot is truncated");
+      const uint8_t byte = data[pos++];
+      number |= uint64_t(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return number;
+    }
+    throw std::runtime_error("Snapshot has too long number");
+  }
+
+  bool isEnd() const { return pos == size; }
+
+ private:
+  const char* data;
+  size_t size;
+  size_t pos = 0;
+};
+
+/**
+ * Encodes rows of the tile as pairs of zero words count and literal words
+ * count, followed by the literal words.
+ */
+static std::string compressTile(const GameField& field,
+                                size_t begin,
+                                size_t end) {
+  const size_t words = field.getRowWords();
+  std::string out;
+  size_t zeros = 0;
+  std::vector<uint64_t> literals;
+  for (size_t i = begin; i < end; i++) {
+    const uint64_t* row = field.getRow(i);
+    for (size_t k = 0; k < words; k++) {
+      if (row[k] != 0) {
+        literals.push_back(row[k]);
+        continue;
+      }
+      if (!literals.empty()) {
+        putNumber(out, zeros);
+        putNumber(out, literals.size());
+        for (uint64_t literal : literals)
+          putWord(out, literal);
+        literals.clear();
+        zeros = 0;
+      }
+      zeros++;
+    }
+  }
+  if (zeros != 0 || !literals.empty()) {
+    putNumber(out, zeros);
+    putNumber(out, literals.size());
+    for (uint64_t literal : literals)
+      putWord(out, literal);
+  }
+  return out;
+}
+
+/**
+ * Appends the given number of bytes of the stream to the data. Bytes are read
+ * by blocks, so the damaged size does not allocate more than the stream has.
+ * Throws std::runtime_error, if the stream ends before.
+ */
+static void readBlock(std::istream& in, std::vector<char>& data, size_t size) {
+  while (size != 0) {
+    const size_t block = std::min(size, READ_BLOCK_SIZE);
+    const size_t used = data.size();
+    data.resize(used + block);
+    in.read(data.data() + used, block);
+    if (static_cast<size_t>(in.gcount()) != block)
+      throw std::runtime_error("Snapshot is truncated");
+    size -= block;
+  }
+}
+
+static void decompressTile(SnapshotReader tile,
+                           GameField& field,
+                           size_t begin,
+                           size_t end) {
+  const size_t words = field.getRowWords();
+  const size_t height = field.getHeight();
+  const uint64_t lastWordMask =
+      height % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (height % 64)) - 1;
+  const size_t total = (end - begin) * words;
+  size_t pos = 0;
+  while (!tile.isEnd()) {
+    const uint64_t zeros = tile.getNumber();
+    const uint64_t literals = tile.getNumber();
+    if (zeros > total - pos || literals > total - pos - zeros)
+      throw std::runtime_error("Snapshot tile is larger than the field");
+    // Field is filled with zeros already
+    pos += zeros;
+    for (uint64_t i = 0; i < literals; i++, pos++) {
+      const size_t k = pos % words;
+      const uint64_t word = tile.getWord();
+      if (k + 1 == words && (word & ~lastWordMask) != 0)
+        throw std::runtime_error("Snapshot has cells outside the field");
+      field.getRow(begin + pos / words)[k] = word;
+    }
+  }
+  if (pos != total)
+    throw std::runtime_error("Snapshot tile is smaller than the field");
+}
+
+void writeSnapshot(std::ostream& out, const GameField& field) {
+  const size_t tiles =
+      (field.getWidth() + SNAPSHOT_TILE_ROWS - 1) / SNAPSHOT_TILE_ROWS;
+  std::vector<std::string> compressed(tiles);
+  runInBands(field.getWidth(), SNAPSHOT_TILE_ROWS,
+             field.getWidth() * field.getRowStride(),
+             [&](size_t, size_t begin, size_t end) {
+               for (size_t i = begin; i < end; i += SNAPSHOT_TILE_ROWS)
+                 compressed[i / SNAPSHOT_TILE_ROWS] = compressTile(
+                     field, i, std::min(i + SNAPSHOT_TILE_ROWS, end));
+             });
+
+  std::string header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  putWord(header, field.getWidth());
+  putWord(header, field.getHeight());
+  putWord(header, field.getBoundary());
+  putWord(header, tiles);
+  // Index of compressed tile sizes, offsets are their sums
+  for (const std::string& tile : compressed)
+    putWord(header, tile.size());
+  out.write(header.data(), header.size());
+  for (const std::string& tile : compressed)
+    out.write(tile.data(), tile.size());
+}
+
+GameField readSnapshot(std::istream& in) {
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+    throw std::runtime_error("Not a snapshot");
+
+  std::vector<char> data;
+  readBlock(in, data, HEADER_FIELDS * 8);
+  SnapshotReader header(data.data(), data.size());
+  const uint64_t width = header.getWord();
+  const uint64_t height = header.getWord();
+  const uint64_t boundary = header.getWord();
+  const uint64_t tiles = header.getWord();
+  if (width > MAX_SNAPSHOT_SIDE || height > MAX_SNAPSHOT_SIDE ||
+      boundary > BOUNDARY_KLEIN ||
+      tiles != (width + SNAPSHOT_TILE_ROWS - 1) / SNAPSHOT_TILE_ROWS)
+    throw std::runtime_error("Snapshot header is damaged");
+
+  // Tiles are placed one after another after the index
+  readBlock(in, data, tiles * 8);
+  SnapshotReader index(data.data() + HEADER_FIELDS * 8, tiles * 8);
+  const size_t offset = data.size();
+  std::vector<size_t> offsets(tiles + 1, offset);
+  for (size_t i = 0; i < tiles; i++) {
+    const uint64_t size = index.getWord();
+    if (size > std::numeric_limits<size_t>::max() - offsets[i])
+      throw std::runtime_error("Snapshot header is damaged");
+    offsets[i + 1] = offsets[i] + size;
+  }
+  readBlock(in, data, offsets[tiles] - offset);
+  if (in.peek() != std::char_traits<char>::eof())
+    throw std::runtime_error("Snapshot has extra data");
+
+  GameField field(width, height);
+  field.setBoundary(static_cast<FieldBoundary>(boundary));
+  // Damage found by band threads is rethrown after all of them finish
+  std::vector<std::string> errors(BandWorkers::getInstance().getThreads());
+  runInBands(width, SNAPSHOT_TILE_ROWS, width * field.getRowStride(),
+             [&](size_t band, size_t begin, size_t end) {
+               try {
+                 for (size_t i = begin; i < end; i += SNAPSHOT_TILE_ROWS) {
+                   const size_t tile = i / SNAPSHOT_TILE_ROWS;
+                   SnapshotReader reader(data.data() + offsets[tile],
+                                         offsets[tile + 1] - offsets[tile]);
+                   decompressTile(reader, field, i,
+                                  std::min(i + SNAPSHOT_TILE_ROWS, end));
+                 }
+               } catch (const std::runtime_error& e) {
+                 errors[band] = e.what();
+               }
+             });
+  for (const std::string& error : errors)
+    if (!error.empty())
+      throw std::runtime_error(error);
+  return field;
+}
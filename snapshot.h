@@ -0,0 +1,34 @@
+//
+//  snapshot.h
+//  GameOfLive
+//
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <istream>
+#include <ostream>
+
+#include "game_field.h"
+
+// Number of rows in each independently compressed tile of the snapshot.
+const size_t SNAPSHOT_TILE_ROWS = 64;
+
+/**
+ * Writes the field in the compressed binary snapshot format.
+ *
+ * Snapshot consists of the header (sizes and boundary), the index of tiles and
+ * compressed tiles. Tile is SNAPSHOT_TILE_ROWS rows of packed cells, encoded
+ * as runs of zero words followed by literal words, so sparse fields take
+ * little space. Tiles are compressed and decompressed independently by bands
+ * of rows in parallel.
+ */
+void writeSnapshot(std::ostream& out, const GameField& field);
+
+/**
+ * Reads the field written by writeSnapshot.
+ * Throws std::runtime_error, if the snapshot is damaged.
+ */
+GameField readSnapshot(std::istream& in);
+
+#endif /* SNAPSHOT_H */
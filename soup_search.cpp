@@ -0,0 +1,105 @@
+//
+//  soup_search.cpp
+//  GameOfLive
+//
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "census.h"
+#include "game_handler.h"
+#include "soup_search.h"
+
+/**
+ * @return Independent seed of the soup with given index.
+ */
+static uint64_t getSoupSeed(uint64_t seed, size_t index) {
+  return mix64(seed ^ (index * GOLDEN_GAMMA));
+}
+
+/**
+ * @return Name of the class of the stabilized field.
+ */
+static std::string classifyField(const GameManager& game) {
+  if (game.getPopulation() == 0)
+    return "empty";
+  if (game.getPeriod() == 1)
+    return "still life";
+  return "period " + std::to_string(game.getPeriod());
+}
+
+void SoupCensus::merge(const SoupCensus& other) {
+  soups += other.soups;
+  unstabilized += other.unstabilized;
+  generations += other.generations;
+  for (auto count : other.states)
+    states[count.first] += count.second;
+  for (auto count : other.objects)
+    objects[count.first] += count.second;
+}
+
+std::ostream& operator<<(std::ostream& stream, const SoupCensus& census) {
+  stream << "Soups: " << census.soups
+         << ", unstabilized: " << census.unstabilized
+         << ", generations: " << census.generations << std::endl;
+  for (auto count : census.states)
+    stream << count.first << ": " << count.second << std::endl;
+  if (!census.objects.empty())
+    stream << "Objects:" << std::endl;
+  for (auto count : census.objects)
+    stream << count.first << ": " << count.second << std::endl;
+  return stream;
+}
+
+SoupCensus SoupSearch::run(size_t soups, uint64_t seed, size_t threads) const {
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+  if (threads > soups)
+    threads = soups;
+
+  std::atomic<size_t> nextSoup(0);
+  std::vector<SoupCensus> results(threads);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; i++)
+    workers.push_back(std::thread(&SoupSearch::runWorker, this, soups, seed,
+                                  std::ref(nextSoup), std::ref(results[i])));
+
+  SoupCensus census;
+  for (size_t i = 0; i < threads; i++) {
+    workers[i].join();
+    census.merge(results[i]);
+  }
+  return census;
+}
+
+void SoupSearch::runWorker(size_t soups,
+                           uint64_t seed,
+                           std::atomic<size_t>& nextSoup,
+                           SoupCensus& census) const {
+  SilentViewHandler view;
+  GameManager game(width, height, view);
+
+  for (size_t index = nextSoup++; index < soups; index = nextSoup++) {
+    game.reset(GameField::createRandom(width, height, density,
+                                       getSoupSeed(seed, index)));
+
+    size_t generation = 0;
+    while (generation < maxGenerations && game.getPeriod() == 0) {
+      game.nextStep();
+      generation++;
+    }
+
+    census.soups++;
+    census.generations += generation;
+    if (game.getPeriod() == 0) {
+      census.unstabilized++;
+      continue;
+    }
+    census.states[classifyField(game)]++;
+    for (auto count : takeCensus(game.getCurrentField()))
+      census.objects[count.first] += count.second;
+  }
+}
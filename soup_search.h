@@ -0,0 +1,85 @@
+//
+//  soup_search.h
+//  GameOfLive
+//
+
+#ifndef SOUP_SEARCH_H
+#define SOUP_SEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * Aggregated results of the soup search.
+ */
+class SoupCensus {
+ public:
+  // Number of searched soups
+  size_t soups = 0;
+
+  // Number of soups, which did not stabilize in the generations limit
+  size_t unstabilized = 0;
+
+  // Total number of computed generations
+  size_t generations = 0;
+
+  // Number of soups by the final state class
+  std::map<std::string, size_t> states;
+
+  // Number of objects in the final states by object name
+  std::map<std::string, size_t> objects;
+
+  void merge(const SoupCensus& other);
+};
+
+/**
+ * Outputs census summary, one class or object per line.
+ */
+std::ostream& operator<<(std::ostream& stream, const SoupCensus& census);
+
+/**
+ * Runs random initial fields until they become static or periodic, classifies
+ * final states and counts remaining objects.
+ */
+class SoupSearch {
+ public:
+  /**
+   * @param density Probability of life in each cell of the initial field.
+   * @param maxGenerations Limit of steps for one soup.
+   */
+  SoupSearch(size_t width,
+             size_t height,
+             double density = 0.5,
+             size_t maxGenerations = 10000)
+      : width(width),
+        height(height),
+        density(density),
+        maxGenerations(maxGenerations) {}
+
+  /**
+   * Searches soups in parallel, each worker has its own field.
+   * Result depends only on the seed, not on the number of threads.
+   *
+   * @param threads Number of workers, if zero, number of cores is used.
+   */
+  SoupCensus run(size_t soups, uint64_t seed, size_t threads = 0) const;
+
+ private:
+  const size_t width;
+  const size_t height;
+  const double density;
+  const size_t maxGenerations;
+
+  /**
+   * Searches soups with indexes taken from the shared counter.
+   */
+  void runWorker(size_t soups,
+                 uint64_t seed,
+                 std::atomic<size_t>& nextSoup,
+                 SoupCensus& census) const;
+};
+
+#endif /* SOUP_SEARCH_H */
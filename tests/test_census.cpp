@@ -0,0 +1,89 @@
+//
+//  test_census.cpp
+//  GameOfLiveTests
+//
+
+#include "gtest/gtest.h"
+
+#include "census.h"
+
+void placeObject(GameField& field, const std::string& object, int posX, int posY) {
+    const GameField from(object);
+    for (int i = 0; i < from.getWidth(); i++)
+        for (int j = 0; j < from.getHeight(); j++)
+            if (from[i][j].isLife())
+                field[posX + i][posY + j].bornLife();
+}
+
+TEST(Census, EmptyField) {
+    ASSERT_TRUE(takeCensus(GameField(10, 10)).empty());
+    ASSERT_TRUE(takeCensus(GameField(0, 0)).empty());
+}
+
+TEST(Census, KnownObjects) {
+    GameField field(30, 30);
+    placeObject(field, "##\n##", 1, 1);
+    placeObject(field, "###", 6, 1);
+    placeObject(field, "#\n#\n#", 10, 10);
+    placeObject(field, ".#.\n..#\n###", 20, 3);
+    placeObject(field, "##.\n#.#\n.#.", 3, 20);
+    placeObject(field, ".#.\n#.#\n.##", 20, 20);
+    
+    std::map<std::string, size_t> census = takeCensus(field);
+    ASSERT_EQ(4, census.size());
+    ASSERT_EQ(1, census["block"]);
+    ASSERT_EQ(2, census["blinker"]);
+    ASSERT_EQ(1, census["glider"]);
+    ASSERT_EQ(2, census["boat"]);
+}
+
+TEST(Census, ObjectsCrossingBorder) {
+    GameField field(20, 16);
+    // Block in the corners and beehive across the side
+    placeObject(field, "##\n##", -1, -1);
+    placeObject(field, ".##.\n#..#\n.##.", 8, -2);
+    // Cells touching by corners through the loop are one object
+    placeObject(field, "#", 5, 15);
+    placeObject(field, "#", 6, 0);
+    
+    std::map<std::string, size_t> census = takeCensus(field);
+    ASSERT_EQ(3, census.size());
+    ASSERT_EQ(1, census["block"]);
+    ASSERT_EQ(1, census["beehive"]);
+    ASSERT_EQ(1, census["2 cells #./.#"]);
+}
+
+TEST(Census, BoundaryWithoutLoop) {
+    GameField field(10, 10);
+    // Blinker across the top and bottom edges, domino across the side edges
+    placeObject(field, "#\n#", 0, 3);
+    placeObject(field, "#", 9, 3);
+    placeObject(field, "#", 5, 0);
+    placeObject(field, "#", 5, 9);
+    ASSERT_EQ(1, takeCensus(field)["blinker"]);
+
+    field.setBoundary(BOUNDARY_DEAD);
+    std::map<std::string, size_t> census = takeCensus(field);
+    ASSERT_EQ(2, census.size());
+    ASSERT_EQ(1, census["2 cells ##"]);
+    ASSERT_EQ(3, census["1 cells #"]);
+
+    // Klein bottle loops the rows, but flips them between the edges
+    field.setBoundary(BOUNDARY_KLEIN);
+    census = takeCensus(field);
+    ASSERT_EQ(2, census.size());
+    ASSERT_EQ(2, census["2 cells ##"]);
+    ASSERT_EQ(1, census["1 cells #"]);
+}
+
+TEST(Census, UnknownObjectsAreCanonical) {
+    GameField field(30, 30);
+    placeObject(field, "#.#\n###", 2, 2);
+    placeObject(field, "##\n#.\n##", 10, 10);
+    placeObject(field, "###\n#.#", 20, 20);
+    
+    std::map<std::string, size_t> census = takeCensus(field);
+    ASSERT_EQ(1, census.size());
+    ASSERT_EQ(3, census.begin()->second);
+    ASSERT_EQ(0, census.begin()->first.find("5 cells "));
+}
@@ -0,0 +1,66 @@
+//
+//  test_field_batch.cpp
+//  GameOfLiveTests
+//
+
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+#include "field_batch.h"
+#include "game_handler.h"
+
+GameField stepField(const GameField& field, size_t steps) {
+    SilentViewHandler view;
+    GameManager game(field, view);
+    for (size_t i = 0; i < steps; i++)
+        game.nextStep();
+    return game.getCurrentField();
+}
+
+TEST(FieldBatch, SameAsGameManager) {
+    FieldBatch batch(17, 23);
+    std::vector<GameField> fields;
+    for (size_t i = 0; i < BATCH_LANES; i++) {
+        fields.push_back(GameField::createRandom(17, 23, 0.05 * (i % 10), i));
+        ASSERT_EQ(i, batch.add(fields.back()));
+    }
+    ASSERT_THROW(batch.add(fields[0]), std::invalid_argument);
+    
+    batch.nextStep(7);
+    
+    for (size_t i = 0; i < BATCH_LANES; i++)
+        ASSERT_EQ(stepField(fields[i], 7), batch.get(i));
+}
+
+TEST(FieldBatch, StepAll) {
+    std::vector<GameField> fields;
+    std::vector<GameField> samples;
+    for (size_t i = 0; i < 150; i++) {
+        fields.push_back(GameField::createRandom(12, 12, 0.4, i));
+        samples.push_back(stepField(fields.back(), 5));
+    }
+    
+    FieldBatch::stepAll(fields, 5);
+    
+    for (size_t i = 0; i < fields.size(); i++)
+        ASSERT_EQ(samples[i], fields[i]);
+}
+
+TEST(FieldBatch, WrongSize) {
+    FieldBatch batch(10, 10);
+    ASSERT_THROW(batch.add(GameField(10, 11)), std::invalid_argument);
+    
+    GameField dead(10, 10);
+    dead.setBoundary(BOUNDARY_DEAD);
+    ASSERT_THROW(batch.add(dead), std::invalid_argument);
+    
+    std::vector<GameField> fields = {GameField(5, 5), GameField(6, 6)};
+    ASSERT_THROW(FieldBatch::stepAll(fields, 1), std::invalid_argument);
+
+    // Fields of the first batch are not stepped, if a later one is wrong
+    fields.assign(BATCH_LANES + 1, GameField::createRandom(5, 5, 0.5, 1));
+    fields.back().setBoundary(BOUNDARY_DEAD);
+    const GameField sample(fields[0]);
+    ASSERT_THROW(FieldBatch::stepAll(fields, 1), std::invalid_argument);
+    ASSERT_EQ(sample, fields[0]);
+}
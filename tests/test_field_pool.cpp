@@ -0,0 +1,71 @@
+//
+//  test_field_pool.cpp
+//  GameOfLiveTests
+//
+
+#include <thread>
+#include "gtest/gtest.h"
+
+#include "field_pool.h"
+#include "game_field.h"
+
+TEST(FieldBufferPool, ReusesBuffers) {
+    FieldBufferPool::clear();
+    FieldBuffer buffer(FieldBufferPool::acquire(100));
+    ASSERT_EQ(100, buffer.size());
+    buffer[5] = 1;
+    const uint64_t* memory = buffer.data();
+    
+    FieldBufferPool::release(buffer);
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_EQ(1, FieldBufferPool::getFreeCount());
+    
+    // Too large buffer is not taken for the small one
+    FieldBuffer small(FieldBufferPool::acquire(10));
+    ASSERT_EQ(1, FieldBufferPool::getFreeCount());
+    
+    FieldBuffer reused(FieldBufferPool::acquire(90));
+    ASSERT_EQ(memory, reused.data());
+    ASSERT_EQ(90, reused.size());
+    ASSERT_EQ(0, reused[5]);
+    ASSERT_EQ(0, FieldBufferPool::getFreeCount());
+}
+
+TEST(FieldBufferPool, FieldsReturnBuffers) {
+    FieldBufferPool::clear();
+    GameField field(64, 64);
+    field.setLifeAt(3, 3, true);
+    {
+        GameField copy(field);
+        ASSERT_EQ(field, copy);
+    }
+    ASSERT_EQ(1, FieldBufferPool::getFreeCount());
+    
+    GameField reset(64, 64);
+    ASSERT_EQ(0, FieldBufferPool::getFreeCount());
+    ASSERT_FALSE(reset.isLifeAt(3, 3));
+}
+
+TEST(FieldBufferPool, LimitsFreeBuffers) {
+    FieldBufferPool::clear();
+    std::vector<FieldBuffer> buffers;
+    for (size_t i = 0; i < MAX_POOLED_BUFFERS * 2; i++)
+        buffers.push_back(FieldBufferPool::acquire(10));
+    for (FieldBuffer& buffer : buffers)
+        FieldBufferPool::release(buffer);
+    ASSERT_EQ(MAX_POOLED_BUFFERS, FieldBufferPool::getFreeCount());
+    
+    FieldBufferPool::clear();
+    ASSERT_EQ(0, FieldBufferPool::getFreeCount());
+}
+
+TEST(FieldBufferPool, FieldsOutliveThePool) {
+    // Fields are created before the pool of the thread, so they are destroyed
+    // after it on the thread exit
+    std::thread thread([] {
+        thread_local std::vector<GameField> fields;
+        fields.push_back(GameField(64, 64));
+        fields.push_back(GameField(fields.back()));
+    });
+    thread.join();
+}
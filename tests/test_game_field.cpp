@@ -6,8 +6,11 @@
 //  Copyright © 2017 Кирилл. All rights reserved.
 //
 
+#include <cmath>
+#include <sstream>
 #include "gtest/gtest.h"
 
+#include "band_workers.h"
 #include "game_field.h"
 
 TEST(GameField, LifeManipulations) {
@@ -75,3 +78,158 @@ TEST(GameField, LifeManipulationsWithOverflow) {
     ASSERT_TRUE(field[10][10].isLife());
     ASSERT_TRUE(field[0][0].isLife());
 }
+
+TEST(GameField, Ghosts) {
+    GameField field(3, 64);
+    field.setLifeAt(0, 0, true);
+    field.setLifeAt(2, 63, true);
+    const GameField sample(field);
+    
+    field.refreshGhosts();
+    const size_t stride = field.getRowStride();
+    // Cells after the row and before it
+    ASSERT_EQ(1, field.getRow(0)[1]);
+    ASSERT_EQ(uint64_t(1) << 63, field.getRow(2)[-1]);
+    // Rows above the first and below the last, with corners
+    ASSERT_EQ(uint64_t(1) << 63, (field.getRow(0) - stride)[0]);
+    ASSERT_EQ(uint64_t(1) << 63, (field.getRow(0) - stride)[-1]);
+    ASSERT_EQ(1, (field.getRow(2) + stride)[0]);
+    ASSERT_EQ(1, (field.getRow(2) + stride)[1]);
+    
+    field.clearGhosts();
+    ASSERT_EQ(sample, field);
+}
+
+TEST(GameField, MoveAndSwap) {
+    GameField field(GameField("#..\n.#.\n..#\n#.."));
+    field.setBoundary(BOUNDARY_MIRROR);
+    const GameField sample(field);
+    const uint64_t* memory = field.getRow(0);
+    
+    GameField moved(std::move(field));
+    ASSERT_EQ(sample, moved);
+    ASSERT_EQ(memory, moved.getRow(0));
+    ASSERT_EQ(BOUNDARY_MIRROR, moved.getBoundary());
+    ASSERT_EQ(0, field.getWidth());
+    
+    GameField other(2, 5);
+    other = std::move(moved);
+    ASSERT_EQ(sample, other);
+    ASSERT_EQ(memory, other.getRow(0));
+    
+    GameField empty(10, 10);
+    swap(empty, other);
+    ASSERT_EQ(sample, empty);
+    ASSERT_EQ(GameField(10, 10), other);
+    ASSERT_EQ(BOUNDARY_TORUS, other.getBoundary());
+}
+
+TEST(GameField, Output) {
+    const GameField field(GameField::createRandom(5, 133, 0.5, 3));
+    std::string sample;
+    for (size_t i = 0; i < field.getWidth(); i++) {
+        for (size_t j = 0; j < field.getHeight(); j++)
+            sample += field.isLifeAt(i, j) ? '#' : '.';
+        if (i + 1 != field.getWidth())
+            sample += '\n';
+    }
+    std::ostringstream out;
+    out << field;
+    ASSERT_EQ(sample, out.str());
+    ASSERT_EQ(field, GameField(out.str()));
+}
+
+TEST(GameField, ParseByChunks) {
+    // Text of several megabytes is parsed by several chunks
+    BandWorkers& workers = BandWorkers::getInstance();
+    workers.setThreads(4);
+    const GameField field(GameField::createRandom(1500, 1000, 0.3, 9));
+    std::ostringstream out;
+    out << field << '\n';
+    std::string text(out.str());
+    ASSERT_EQ(field, GameField(text));
+    
+    text[1000 * 1001 + 7] = 'x';
+    text[1200 * 1001 + 1000] = '.';
+    try {
+        GameField wrong(text);
+        FAIL();
+    } catch (const BadGameFieldException& e) {
+        ASSERT_EQ(std::string("Unknown character 'x' at line 1000, position 7"),
+                  e.what());
+    }
+    text[1000 * 1001 + 7] = '.';
+    try {
+        GameField wrong(text);
+        FAIL();
+    } catch (const BadGameFieldException& e) {
+        ASSERT_EQ(std::string("Invalid number of characters in the line "
+                              "at line 1200, position 2001"), e.what());
+    }
+    workers.setThreads(0);
+}
+
+TEST(GameField, Random) {
+    ASSERT_EQ(GameField(7, 130), GameField::createRandom(7, 130, 0, 1));
+    ASSERT_EQ(GameField(7, 130), GameField::createRandom(7, 130, NAN, 1));
+    const GameField full(GameField::createRandom(7, 130, 1, 1));
+    for (size_t i = 0; i < 7; i++)
+        for (size_t j = 0; j < 130; j++)
+            ASSERT_TRUE(full.isLifeAt(i, j));
+    ASSERT_EQ(0, full.getRow(0)[2] >> 2);
+    
+    // Population is close to the density
+    const double densities[] = {0.01, 0.3, 0.5, 0.77};
+    for (double density : densities) {
+        const GameField field(GameField::createRandom(1000, 1000, density, 2));
+        size_t population = 0;
+        for (size_t i = 0; i < 1000; i++)
+            for (size_t j = 0; j < 1000; j++)
+                population += field.isLifeAt(i, j);
+        ASSERT_NEAR(density * 1e6, population, 3e3);
+    }
+    
+    // Field depends only on the seed, not on bands
+    BandWorkers& workers = BandWorkers::getInstance();
+    workers.setThreads(1);
+    const GameField single(GameField::createRandom(4096, 4096, 0.3, 5));
+    workers.setThreads(4);
+    ASSERT_EQ(single, GameField::createRandom(4096, 4096, 0.3, 5));
+    ASSERT_FALSE(single == GameField::createRandom(4096, 4096, 0.3, 6));
+    workers.setThreads(0);
+}
+
+TEST(GameField, RawRows) {
+    GameField field(3, 70);
+    ASSERT_EQ(2, field.getRowWords());
+    
+    field.setLifeAt(1, 0, true);
+    field.setLifeAt(1, 65, true);
+    field.setLifeAt(2, 69, true);
+    ASSERT_EQ(1, field.getRow(1)[0]);
+    ASSERT_EQ(2, field.getRow(1)[1]);
+    ASSERT_EQ(uint64_t(1) << 5, field.getRow(2)[1]);
+    
+    ASSERT_TRUE(field.isLifeAt(1, 65));
+    ASSERT_TRUE(field[1][65].isLife());
+    ASSERT_TRUE(field[-1][-1].isLife());
+    ASSERT_FALSE(field.isLifeAt(0, 65));
+    
+    field.setLifeAt(1, 65, false);
+    ASSERT_EQ(0, field.getRow(1)[1]);
+    ASSERT_FALSE(field[1][65].isLife());
+    
+    GameField single(1, 1);
+    single[-1][-2].bornLife();
+    ASSERT_TRUE(single.isLifeAt(0, 0));
+}
+
+TEST(GameField, Equality) {
+    GameField field(4, 5);
+    ASSERT_EQ(GameField(4, 5), field);
+    ASSERT_FALSE(GameField(5, 4) == field);
+    
+    field[2][3].bornLife();
+    ASSERT_FALSE(GameField(4, 5) == field);
+    ASSERT_EQ(GameField("....\n....\n...#\n....\n...."), GameField("....\n....\n...#\n....\n....\n"));
+}
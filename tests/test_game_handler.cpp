@@ -6,10 +6,17 @@
 //  Copyright © 2017 Кирилл. All rights reserved.
 //
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <string>
+#include <thread>
 #include <sstream>
+#include <stdexcept>
 #include "gtest/gtest.h"
 
+#include "band_workers.h"
 #include "game_handler.h"
 
 std::string fieldToString(const GameField& field) {
@@ -18,6 +25,11 @@ std::string fieldToString(const GameField& field) {
     return str.str();
 }
 
+std::string getTempFilename(const std::string& name) {
+    const char* dir = std::getenv("TMPDIR");
+    return std::string(dir != nullptr ? dir : "/tmp") + "/" + name;
+}
+
 class TestingListener : public ViewHandler {
 public:
     
@@ -90,6 +102,65 @@ void testGameStep(const std::string& from, const std::string& to) {
     game.nextStep();
 }
 
+bool isReferenceLife(const GameField& field, int x, int y) {
+    const int width = field.getWidth();
+    const int height = field.getHeight();
+    switch (field.getBoundary()) {
+        case BOUNDARY_DEAD:
+            return x >= 0 && y >= 0 && x < width && y < height &&
+                   field.isLifeAt(x, y);
+        case BOUNDARY_MIRROR:
+            return field.isLifeAt(std::min(std::max(x, 0), width - 1),
+                                  std::min(std::max(y, 0), height - 1));
+        case BOUNDARY_KLEIN:
+            if (x < 0 || x >= width)
+                y = height - 1 - y;
+            break;
+        case BOUNDARY_TORUS:
+            break;
+    }
+    return field[x][y].isLife();
+}
+
+GameField makeReferenceStep(const GameField& field) {
+    GameField next(field);
+    for (int i = 0; i < field.getWidth(); i++)
+        for (int j = 0; j < field.getHeight(); j++) {
+            size_t life = 0;
+            for (int x = i - 1; x <= i + 1; x++)
+                for (int y = j - 1; y <= j + 1; y++)
+                    if ((x != i || y != j) && isReferenceLife(field, x, y))
+                        life++;
+            if (life == 3)
+                next[i][j].bornLife();
+            else if (life != 2)
+                next[i][j].kill();
+        }
+    return next;
+}
+
+void testReferenceSteps(size_t width, size_t height, double density,
+                        FieldBoundary boundary = BOUNDARY_TORUS) {
+    TestingListener catcher;
+    GameField sample(GameField::createRandom(width, height, density, width * height));
+    sample.setBoundary(boundary);
+    GameManager game(sample, catcher);
+    for (int step = 0; step < 4; step++) {
+        GameField next(makeReferenceStep(sample));
+        size_t births = 0, deaths = 0;
+        for (size_t i = 0; i < width; i++)
+            for (size_t j = 0; j < height; j++) {
+                births += !sample.isLifeAt(i, j) && next.isLifeAt(i, j);
+                deaths += sample.isLifeAt(i, j) && !next.isLifeAt(i, j);
+            }
+        sample = next;
+        game.nextStep();
+        ASSERT_EQ(sample, game.getCurrentField());
+        ASSERT_EQ(births, game.getBirths());
+        ASSERT_EQ(deaths, game.getDeaths());
+    }
+}
+
 TEST(GameHandler, ParseFieldRight) {
     testParseField("");
     testParseField("###\n###\n###");
@@ -115,6 +186,7 @@ TEST(GameHandler, ParseFieldWrongSize) {
     testWrongParseField("...\n..");
     testWrongParseField(".\n\n\n");
     testWrongParseField("##\n.\n##");
+    testWrongParseField("#\n" + std::string(200, '#'));
 }
 
 TEST(GameHandler, NextStep) {
@@ -122,6 +194,405 @@ TEST(GameHandler, NextStep) {
     testGameStep("#", ".");
     testGameStep("....\n.###\n.###\n.###", "..#..\n.#.#.\n#...#\n.#.#.\n..#..");
 }
+TEST(GameHandler, NextStepLikeReference) {
+    testReferenceSteps(10, 10, 0.4);
+    testReferenceSteps(1, 7, 0.5);
+    testReferenceSteps(7, 1, 0.5);
+    testReferenceSteps(2, 2, 0.5);
+    testReferenceSteps(3, 64, 0.4);
+    testReferenceSteps(70, 65, 0.3);
+    testReferenceSteps(33, 130, 0.5);
+}
+
+TEST(GameHandler, BoundariesLikeReference) {
+    const FieldBoundary boundaries[] = {BOUNDARY_DEAD, BOUNDARY_MIRROR,
+                                        BOUNDARY_KLEIN};
+    for (FieldBoundary boundary : boundaries) {
+        testReferenceSteps(10, 10, 0.4, boundary);
+        testReferenceSteps(1, 7, 0.5, boundary);
+        testReferenceSteps(7, 1, 0.5, boundary);
+        testReferenceSteps(3, 64, 0.4, boundary);
+        testReferenceSteps(70, 65, 0.3, boundary);
+        testReferenceSteps(33, 130, 0.5, boundary);
+    }
+}
+
+TEST(GameHandler, BandsLikeSingleThread) {
+    TestingListener catcher;
+    const GameField field(GameField::createRandom(4096, 4096, 0.3, 7));
+    BandWorkers& workers = BandWorkers::getInstance();
+    workers.setThreads(1);
+    GameManager single(field, catcher);
+    workers.setThreads(4);
+    GameManager bands(field, catcher);
+    ASSERT_EQ(4, workers.getBandsCount(4096 * field.getRowStride()));
+    
+    for (int step = 0; step < 3; step++) {
+        workers.setThreads(1);
+        single.nextStep();
+        workers.setThreads(4);
+        bands.nextStep();
+        ASSERT_EQ(single.getCurrentField(), bands.getCurrentField());
+        ASSERT_EQ(single.getBirths(), bands.getBirths());
+        ASSERT_EQ(single.getDeaths(), bands.getDeaths());
+        ASSERT_EQ(single.getFieldHash(), bands.getFieldHash());
+    }
+    workers.setThreads(0);
+}
+
+TEST(GameHandler, SnapshotCommand) {
+    TestingListener catcher;
+    GameField field(GameField::createRandom(70, 90, 0.2, 5));
+    field.setBoundary(BOUNDARY_MIRROR);
+    GameManager game(field, catcher);
+    std::ostringstream out;
+    const std::string filename = getTempFilename("test.snap");
+    ASSERT_TRUE(game.executeCommand("snapshot", {"save", filename}, out));
+    
+    game.reset(10, 10);
+    ASSERT_TRUE(game.executeCommand("snapshot", {"load", filename}, out));
+    ASSERT_EQ(field, game.getCurrentField());
+    ASSERT_EQ(BOUNDARY_MIRROR, game.getCurrentField().getBoundary());
+    ASSERT_EQ(0, game.getStepsCount());
+    std::remove(filename.c_str());
+}
+
+TEST(GameHandler, LoadCommand) {
+    TestingListener catcher;
+    const GameField field(GameField::createRandom(30, 70, 0.4, 3));
+    GameManager game(field, catcher);
+    std::ostringstream out;
+    const std::string filename = getTempFilename("test_load.txt");
+    ASSERT_TRUE(game.executeCommand("save", {filename}, out));
+    
+    game.reset(10, 10);
+    ASSERT_TRUE(game.executeCommand("load", {filename}, out));
+    ASSERT_EQ(field, game.getCurrentField());
+    std::remove(filename.c_str());
+    
+    // Directory is reported like a missing file
+    std::ostringstream directory;
+    ASSERT_TRUE(game.executeCommand("load", {getTempFilename("")}, directory));
+    ASSERT_NE(std::string::npos, directory.str().find("Cannot load file"));
+    ASSERT_EQ(field, game.getCurrentField());
+}
+
+TEST(GameHandler, BoundaryCommand) {
+    TestingListener catcher;
+    GameManager game(10, 10, catcher);
+    std::ostringstream out;
+    ASSERT_TRUE(game.executeCommand("boundary", {"dead"}, out));
+    ASSERT_EQ(BOUNDARY_DEAD, game.getCurrentField().getBoundary());
+    
+    // Blinker on the edge dies without neighbours from the opposite edge
+    game.setCellAt(0, 0);
+    game.setCellAt(0, 1);
+    game.setCellAt(0, 2);
+    game.nextStep();
+    ASSERT_EQ(2, game.getPopulation());
+    
+    game.reset(5, 5);
+    ASSERT_EQ(BOUNDARY_DEAD, game.getCurrentField().getBoundary());
+    ASSERT_TRUE(game.executeCommand("boundary", {"unknown"}, out));
+    ASSERT_EQ(BOUNDARY_DEAD, game.getCurrentField().getBoundary());
+
+    // Undo of the step does not revert the boundary
+    game.nextStep();
+    ASSERT_TRUE(game.executeCommand("boundary", {"mirror"}, out));
+    ASSERT_TRUE(game.stepBack());
+    ASSERT_EQ(BOUNDARY_MIRROR, game.getCurrentField().getBoundary());
+}
+
+TEST(GameHandler, PlaceCommand) {
+    TestingListener catcher;
+    GameManager game(10, 70, catcher);
+    std::ostringstream out;
+    game.setCellAt(0, 0);
+    
+    // Glider is looped over the corner of the field
+    ASSERT_TRUE(game.executeCommand("place", {"glider", "9", "69", "90"}, out));
+    GameField sample(10, 70);
+    sample[0][0].bornLife();
+    sample[9][69].bornLife();
+    sample[10][69].bornLife();
+    sample[10][71].bornLife();
+    sample[11][69].bornLife();
+    sample[11][70].bornLife();
+    ASSERT_EQ(sample, game.getCurrentField());
+    ASSERT_EQ(6, game.getPopulation());
+    GameManager recounted(sample, catcher);
+    ASSERT_EQ(recounted.getFieldHash(), game.getFieldHash());
+    
+    // Placing is cancelled without changing the steps counter
+    ASSERT_TRUE(game.stepBack());
+    GameField single(10, 70);
+    single[0][0].bornLife();
+    ASSERT_EQ(single, game.getCurrentField());
+    ASSERT_EQ(1, game.getPopulation());
+    
+    // Words of the row are crossed by the pattern
+    game.placePattern(GameField("#.#.#"), 3, 62);
+    ASSERT_EQ(4, game.getPopulation());
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(3, 66));
+    ASSERT_THROW(game.placePattern(GameField(11, 1), 0, 0),
+                 std::invalid_argument);
+    
+    ASSERT_TRUE(game.executeCommand("place", {"unknown", "0", "0"}, out));
+    ASSERT_TRUE(game.executeCommand("place", {"glider", "0", "0", "45"}, out));
+    ASSERT_EQ(4, game.getPopulation());
+}
+
+TEST(GameHandler, RegionCommands) {
+    TestingListener catcher;
+    GameManager game(10, 200, catcher);
+    std::ostringstream out;
+    
+    // Region is looped over the corner and crosses words of rows
+    ASSERT_TRUE(game.executeCommand("fill", {"8", "150", "4", "100"}, out));
+    GameField sample(10, 200);
+    for (int i = 8; i < 12; i++)
+        for (int j = 150; j < 250; j++)
+            sample[i][j].bornLife();
+    ASSERT_EQ(sample, game.getCurrentField());
+    ASSERT_EQ(400, game.getPopulation());
+    ASSERT_EQ(GameManager(sample, catcher).getFieldHash(), game.getFieldHash());
+    
+    ASSERT_TRUE(game.executeCommand("clear", {"9", "190", "2", "20"}, out));
+    ASSERT_EQ(360, game.getPopulation());
+    ASSERT_FALSE(game.getCurrentField().isLifeAt(0, 5));
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(0, 10));
+    
+    // Operation is cancelled at once
+    ASSERT_TRUE(game.stepBack());
+    ASSERT_EQ(sample, game.getCurrentField());
+    ASSERT_EQ(400, game.getPopulation());
+    
+    // Copied dead cells replace living ones on paste
+    game.reset(10, 200);
+    game.placePattern(GameField("#.#\n.#."), 2, 3);
+    ASSERT_TRUE(game.executeCommand("copy", {"2", "3", "2", "3"}, out));
+    ASSERT_EQ(GameField("#.#\n.#."), game.getClipboard());
+    game.fillRegion(5, 198, 3, 4, true);
+    ASSERT_TRUE(game.executeCommand("paste", {"5", "198"}, out));
+    ASSERT_EQ(3 + 12 - 6 + 3, game.getPopulation());
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(5, 198));
+    ASSERT_FALSE(game.getCurrentField().isLifeAt(5, 199));
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(5, 0));
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(7, 0));
+    
+    // Random region is the same as the random field of its size
+    game.reset(10, 200);
+    ASSERT_TRUE(game.executeCommand("random", {"0", "0", "10", "200", "0.3",
+                                               "7"}, out));
+    ASSERT_EQ(GameField::createRandom(10, 200, 0.3, 7), game.getCurrentField());
+    
+    ASSERT_TRUE(game.executeCommand("fill", {"0", "0", "11", "1"}, out));
+    ASSERT_TRUE(game.executeCommand("fill", {"0", "0"}, out));
+    ASSERT_TRUE(game.executeCommand("fill", {"0", "0", "-1", "1"}, out));
+    ASSERT_TRUE(game.executeCommand("fill", {"0", "0", "1", "x"}, out));
+    ASSERT_TRUE(game.executeCommand("fill", {"0", "0", "1x", "1"}, out));
+    ASSERT_EQ(GameField::createRandom(10, 200, 0.3, 7), game.getCurrentField());
+    
+    // Whole field is replaced and the steps counter is reset
+    game.nextStep();
+    ASSERT_TRUE(game.executeCommand("random", {"0.2", "9"}, out));
+    ASSERT_EQ(GameField::createRandom(10, 200, 0.2, 9), game.getCurrentField());
+    ASSERT_EQ(0, game.getStepsCount());
+    
+    ASSERT_TRUE(game.executeCommand("random", {"nan"}, out));
+    ASSERT_TRUE(game.executeCommand("random", {"0", "0", "2", "2", "inf"}, out));
+    ASSERT_EQ(GameField::createRandom(10, 200, 0.2, 9), game.getCurrentField());
+}
+
+class RenderCounter : public TestingListener {
+public:
+    void updateField(const GameField& field, size_t stepsCount) override {
+        renders++;
+    }
+    
+    const InputResult waitForInput(uint8_t timeout) override {
+        waits++;
+        return InputResult();
+    }
+    
+    size_t renders = 0;
+    size_t waits = 0;
+};
+
+TEST(GameHandler, RunScript) {
+    RenderCounter counter;
+    GameManager game(10, 10, counter);
+    const std::string filename = getTempFilename("test_script.txt");
+    std::ofstream(filename)
+        << "# Blinker\n"
+        << "\n"
+        << "set 1 0\r\n"
+        << "  set   1 1\n"
+        << "set 1 2\n"
+        << "step 5\n";
+    std::ostringstream out;
+    ASSERT_TRUE(game.executeCommand("run", {filename}, out));
+    ASSERT_EQ(5, game.getStepsCount());
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(0, 1));
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(2, 1));
+    ASSERT_EQ(3, game.getPopulation());
+    ASSERT_NE(std::string::npos, out.str().find("Done 5 step(s)."));
+    
+    // Field is drawn once, steps are not delayed
+    ASSERT_EQ(1, counter.renders);
+    ASSERT_EQ(0, counter.waits);
+    ASSERT_FALSE(game.isRenderingSuppressed());
+    
+    // Script stops at the unknown command
+    std::istringstream script("set 0 0\nunknown 1\nset 5 5\n");
+    ASSERT_FALSE(game.runScript(script, out));
+    ASSERT_NE(std::string::npos, out.str().find("at line 2."));
+    ASSERT_FALSE(game.getCurrentField().isLifeAt(5, 5));
+    
+    // Script stops at the failed command
+    std::istringstream wrongArgs("set 0 1\nstep x\nset 5 5\n");
+    std::ostringstream failed;
+    ASSERT_FALSE(game.runScript(wrongArgs, failed));
+    ASSERT_NE(std::string::npos,
+              failed.str().find("Command \"step\" failed at line 2"));
+    ASSERT_FALSE(game.getCurrentField().isLifeAt(5, 5));
+    ASSERT_FALSE(game.isRenderingSuppressed());
+    
+    // Infinite steps are not interrupted in scripts
+    std::istringstream infinite("set 0 2\nstep -\nset 5 5\n");
+    std::ostringstream infiniteOut;
+    ASSERT_FALSE(game.runScript(infinite, infiniteOut));
+    ASSERT_NE(std::string::npos,
+              infiniteOut.str().find("Need a step count in scripts"));
+    ASSERT_FALSE(game.getCurrentField().isLifeAt(5, 5));
+    
+    // Failure of the nested script stops the outer one
+    std::ofstream(filename) << "set 6 6\nunknown\n";
+    std::istringstream outer("run " + filename + "\nset 7 7\n");
+    ASSERT_FALSE(game.runScript(outer, out));
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(6, 6));
+    ASSERT_FALSE(game.getCurrentField().isLifeAt(7, 7));
+    
+    // Script running itself is stopped
+    std::ofstream(filename) << "set 9 9\nrun " << filename << "\n";
+    std::ostringstream nested;
+    ASSERT_TRUE(game.executeCommand("run", {filename}, nested));
+    ASSERT_NE(std::string::npos, nested.str().find("nested too deeply"));
+    ASSERT_FALSE(game.isRenderingSuppressed());
+    std::remove(filename.c_str());
+}
+
+class TypingListener : public TestingListener {
+public:
+    TypingListener(const std::string& keys) : keys(keys) {}
+    
+    void updateCommandLine(const std::string& commandOutput) override {
+        commandLine = commandOutput;
+    }
+    
+    const InputResult waitForInput(uint8_t timeout) override {
+        if (typed == keys.size())
+            return InputResult();
+        return InputResult(keys[typed++]);
+    }
+    
+    const InputResult waitForInputUntil(
+        std::chrono::steady_clock::time_point deadline) override {
+        if (typed == keys.size())
+            std::this_thread::sleep_until(deadline);
+        return waitForInput(1);
+    }
+    
+    std::string keys;
+    size_t typed = 0;
+    std::string commandLine;
+};
+
+TEST(GameHandler, ConsoleDuringSteps) {
+    // Steps are not delayed, so keys are typed one per generation, "i" of the
+    // typed command does not interrupt steps
+    TypingListener typing("fill 0 0 2 2\nxy\x7f\x7f\npoq\x7fp\ni");
+    GameManager game(50, 50, typing);
+    game.placePattern(GameField(".#.\n..#\n###"), 20, 20);
+    std::ostringstream out;
+    ASSERT_TRUE(game.executeCommand("speed", {"max"}, out));
+    ASSERT_TRUE(game.executeCommand("step", {"1000"}, out));
+    ASSERT_EQ(typing.keys.size(), game.getStepsCount());
+    ASSERT_NE(std::string::npos, out.str().find("Done 25 step(s)."));
+    ASSERT_TRUE(game.getCurrentField().isLifeAt(0, 0));
+    ASSERT_NE(std::string::npos, typing.commandLine.find("Population: 9"));
+    
+    // Commands may be queued from other threads
+    std::thread other([&game]() { game.queueCommand("clear 0 0 2 2"); });
+    other.join();
+    game.queueCommand("unknown");
+    ASSERT_NE(std::string::npos,
+              game.executeQueuedCommands().find("\"unknown\" not found"));
+    ASSERT_FALSE(game.getCurrentField().isLifeAt(0, 0));
+    ASSERT_EQ(5, game.getPopulation());
+    ASSERT_EQ("", game.executeQueuedCommands());
+    
+    // Steps are not started inside the running steps
+    TypingListener stepping("step 5\ni");
+    GameManager steps(50, 50, stepping);
+    steps.placePattern(GameField(".#.\n..#\n###"), 20, 20);
+    ASSERT_TRUE(steps.executeCommand("speed", {"max"}, out));
+    ASSERT_TRUE(steps.executeCommand("step", {"1000"}, out));
+    ASSERT_EQ(stepping.keys.size(), steps.getStepsCount());
+    ASSERT_NE(std::string::npos,
+              stepping.commandLine.find("cannot be run during steps"));
+}
+
+TEST(GameHandler, Speed) {
+    TypingListener typing("");
+    GameManager game(10, 10, typing);
+    ASSERT_EQ(DEFAULT_SPEED, game.getSpeed());
+    std::ostringstream out;
+    ASSERT_TRUE(game.executeCommand("speed", {"0"}, out));
+    ASSERT_EQ(DEFAULT_SPEED, game.getSpeed());
+    ASSERT_TRUE(game.executeCommand("speed", {"100"}, out));
+    ASSERT_EQ(100, game.getSpeed());
+    
+    game.changeSpeed(false);
+    ASSERT_EQ(50, game.getSpeed());
+    game.setSpeed(MAX_LIMITED_SPEED);
+    game.changeSpeed(true);
+    ASSERT_EQ(0, game.getSpeed());
+    game.changeSpeed(true);
+    ASSERT_EQ(0, game.getSpeed());
+    game.changeSpeed(false);
+    ASSERT_EQ(MAX_LIMITED_SPEED, game.getSpeed());
+    game.setSpeed(1);
+    game.changeSpeed(false);
+    ASSERT_EQ(1, game.getSpeed());
+    
+    // Too slow speeds are rejected by the command and raised by the setter
+    ASSERT_TRUE(game.executeCommand("speed", {"1e-300"}, out));
+    ASSERT_EQ(1, game.getSpeed());
+    game.setSpeed(0.001);
+    ASSERT_EQ(1, game.getSpeed());
+    
+    // Passed time point is not waited for by default
+    RenderCounter counter;
+    ASSERT_TRUE(counter
+                    .waitForInputUntil(std::chrono::steady_clock::now() -
+                                       std::chrono::seconds(1))
+                    .isTimedOut());
+    ASSERT_EQ(0, counter.waits);
+    
+    // Generations follow the clock, speed is changed by keys while steps are
+    // running
+    typing.keys = "+-+";
+    game.placePattern(GameField(".#.\n..#\n###"), 2, 2);
+    game.setSpeed(20);
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(game.executeCommand("step", {"5"}, out));
+    const std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    ASSERT_EQ(40, game.getSpeed());
+    ASSERT_LE(0.04, time.count());
+}
+
 /*
  .....  ..#..
  .###.  .#.#.
@@ -173,3 +644,123 @@ TEST(GameHandler, StepBack) {
     
     game.stepBack();
 }
+
+class StatisticsListener : public TestingListener {
+public:
+    void updateStatistics(const GameStatistics& statistics) override {
+        last = statistics;
+        updates++;
+    }
+    
+    GameStatistics last;
+    size_t updates = 0;
+};
+
+TEST(GameHandler, Statistics) {
+    StatisticsListener listener;
+    GameField field(10, 10);
+    placeFieldOnField(field, GameField(".#.\n.#.\n.#."));
+    GameManager game(field, listener);
+    
+    game.nextStep();
+    ASSERT_EQ(0, listener.updates);
+    
+    game.setStatisticsShown(true);
+    ASSERT_EQ(1, listener.updates);
+    ASSERT_EQ(3, listener.last.population);
+    
+    game.nextStep();
+    ASSERT_EQ(2, listener.updates);
+    ASSERT_EQ(3, listener.last.population);
+    ASSERT_EQ(1, listener.last.activeTiles);
+    ASSERT_LT(0, listener.last.memoryBytes);
+    
+    game.setCellAt(9, 9);
+    ASSERT_EQ(4, listener.last.population);
+    ASSERT_TRUE(game.stepBack());
+    ASSERT_EQ(3, listener.last.population);
+}
+
+TEST(GameHandler, PopulationCounters) {
+    TestingListener catcher;
+    GameField field(10, 10);
+    placeFieldOnField(field, GameField(".#...\n.#...\n.#...\n.....\n....#"));
+    GameManager game(field, catcher);
+    ASSERT_EQ(4, game.getPopulation());
+    
+    game.nextStep();
+    ASSERT_EQ(3, game.getPopulation());
+    ASSERT_EQ(2, game.getBirths());
+    ASSERT_EQ(3, game.getDeaths());
+    
+    game.setCellAt(7, 7);
+    ASSERT_EQ(4, game.getPopulation());
+    
+    game.stepBack();
+    ASSERT_EQ(3, game.getPopulation());
+    
+    game.reset(5, 5);
+    ASSERT_EQ(0, game.getPopulation());
+    ASSERT_EQ(0, game.getBirths());
+    ASSERT_EQ(0, game.getDeaths());
+}
+
+size_t stepsUntilPeriodic(GameManager& game, size_t maxSteps) {
+    for (size_t i = 1; i <= maxSteps; i++) {
+        game.nextStep();
+        if (game.getPeriod() != 0)
+            return i;
+    }
+    return 0;
+}
+
+TEST(GameHandler, PeriodDetection) {
+    TestingListener catcher;
+    GameField block(10, 10);
+    placeFieldOnField(block, GameField("##\n##"));
+    GameManager still(block, catcher);
+    ASSERT_EQ(1, stepsUntilPeriodic(still, 10));
+    ASSERT_EQ(1, still.getPeriod());
+    
+    GameField blinker(10, 10);
+    placeFieldOnField(blinker, GameField(".#.\n.#.\n.#."));
+    GameManager oscillator(blinker, catcher);
+    const uint64_t initialHash = oscillator.getFieldHash();
+    ASSERT_EQ(2, stepsUntilPeriodic(oscillator, 10));
+    ASSERT_EQ(2, oscillator.getPeriod());
+    ASSERT_EQ(initialHash, oscillator.getFieldHash());
+    
+    ASSERT_TRUE(oscillator.stepBack());
+    ASSERT_EQ(0, oscillator.getPeriod());
+    ASSERT_NE(initialHash, oscillator.getFieldHash());
+    
+    // Glider returns to the same place of 10x10 torus after 40 steps
+    GameField glider(10, 10);
+    placeFieldOnField(glider, GameField(".#.\n..#\n###"));
+    GameManager spaceship(glider, catcher);
+    ASSERT_EQ(40, stepsUntilPeriodic(spaceship, 100));
+    ASSERT_EQ(40, spaceship.getPeriod());
+    
+    spaceship.setCellAt(5, 5);
+    ASSERT_EQ(0, spaceship.getPeriod());
+}
+
+TEST(GameHandler, FastForward) {
+    TestingListener catcher;
+    GameField blinker(10, 10);
+    placeFieldOnField(blinker, GameField(".#.\n.#.\n.#."));
+    GameManager game(blinker, catcher);
+    ASSERT_EQ(0, game.fastForward(100));
+    
+    std::ostringstream out;
+    ASSERT_TRUE(game.executeCommand("step", {"1000001"}, out));
+    ASSERT_EQ("Done 1000001 step(s).\n", out.str());
+    ASSERT_EQ(1000001, game.getStepsCount());
+    
+    GameField sample(10, 10);
+    placeFieldOnField(sample, GameField("...\n###\n..."));
+    ASSERT_EQ(sample, game.getCurrentField());
+    
+    ASSERT_EQ(4, game.fastForward(5));
+    ASSERT_EQ(1000005, game.getStepsCount());
+}
@@ -0,0 +1,145 @@
+//
+//  test_pattern_library.cpp
+//  GameOfLiveTests
+//
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "gtest/gtest.h"
+
+#include "band_workers.h"
+#include "pattern_library.h"
+
+std::string toRle(const GameField& field) {
+    std::ostringstream out;
+    out << "x = " << field.getHeight() << ", y = " << field.getWidth() << "\n";
+    size_t lineLength = 0;
+    auto put = [&](size_t run, char symbol) {
+        const std::string item = (run > 1 ? std::to_string(run) : "") + symbol;
+        if (lineLength + item.size() > 70) {
+            out << '\n';
+            lineLength = 0;
+        }
+        out << item;
+        lineLength += item.size();
+    };
+    for (size_t i = 0; i < field.getWidth(); i++) {
+        for (size_t j = 0; j < field.getHeight();) {
+            size_t run = 1;
+            while (j + run < field.getHeight() &&
+                   field.isLifeAt(i, j + run) == field.isLifeAt(i, j))
+                run++;
+            put(run, field.isLifeAt(i, j) ? 'o' : 'b');
+            j += run;
+        }
+        put(1, i + 1 == field.getWidth() ? '!' : '$');
+    }
+    return out.str();
+}
+
+TEST(PatternLibrary, ParseRle) {
+    ASSERT_EQ(GameField(".#.\n..#\n###"),
+              parseRle("#N Glider\n#C comment\nx = 3, y = 3, rule = B3/S23\n"
+                       "bo$2bo$\n3o!"));
+    // Trailing dead cells and empty rows are omitted
+    ASSERT_EQ(GameField("#...\n....\n.##."),
+              parseRle("x = 4, y = 3\r\no2$b2o!"));
+
+    // Run crosses word boundary
+    const GameField wide(parseRle("x = 200, y = 1\n60b70o!"));
+    for (size_t j = 0; j < 200; j++)
+        ASSERT_EQ(j >= 60 && j < 130, wide.isLifeAt(0, j));
+}
+
+TEST(PatternLibrary, ParseBadRle) {
+    ASSERT_THROW(parseRle(""), BadGameFieldException);
+    ASSERT_THROW(parseRle("#C only comment"), BadGameFieldException);
+    ASSERT_THROW(parseRle("y = 3\n3o!"), BadGameFieldException);
+    ASSERT_THROW(parseRle("x = 2, y = 1\n3o!"), BadGameFieldException);
+    ASSERT_THROW(parseRle("x = 2, y = 1\no$o!"), BadGameFieldException);
+    ASSERT_THROW(parseRle("x = 2, y = 1\n2A!"), BadGameFieldException);
+    
+    // Huge sizes are reported before allocation
+    ASSERT_THROW(parseRle("x = 99999999999999999999999, y = 1\no!"),
+                 BadGameFieldException);
+    ASSERT_THROW(parseRle("x = 4000000000, y = 1\no!"), BadGameFieldException);
+    ASSERT_THROW(parseRle("x = 1000000, y = 1000000\no!"),
+                 BadGameFieldException);
+}
+
+TEST(PatternLibrary, ParseRleByChunks) {
+    // Pattern of several megabytes is parsed by several chunks
+    BandWorkers& workers = BandWorkers::getInstance();
+    workers.setThreads(4);
+    const GameField field(GameField::createRandom(3000, 1000, 0.5, 4));
+    std::string rle(toRle(field));
+    ASSERT_LT(1, workers.getBandsCount(rle.size() / 8));
+    ASSERT_EQ(field, parseRle(rle));
+    ASSERT_EQ(field, parseRle(rle + "\n" + std::string(rle.size(), 'z')));
+    
+    size_t pos = rle.find_first_of("bo", rle.size() * 3 / 4);
+    rle[pos] = 'z';
+    const size_t line = std::count(rle.begin(), rle.begin() + pos, '\n');
+    const size_t linePos = pos - rle.rfind('\n', pos) - 1;
+    try {
+        parseRle(rle);
+        FAIL();
+    } catch (const BadGameFieldException& e) {
+        ASSERT_EQ("Unknown cell state at line " + std::to_string(line) +
+                      ", position " + std::to_string(linePos),
+                  e.what());
+    }
+    workers.setThreads(0);
+}
+
+TEST(PatternLibrary, Rotations) {
+    const Pattern pattern(GameField("##.\n..#"));
+    ASSERT_EQ(GameField("##.\n..#"), pattern.getRotation(0));
+    ASSERT_EQ(GameField(".#\n.#\n#."), pattern.getRotation(1));
+    ASSERT_EQ(GameField("#..\n.##"), pattern.getRotation(2));
+    ASSERT_EQ(GameField(".#\n#.\n#."), pattern.getRotation(3));
+    ASSERT_EQ(pattern.getRotation(0), pattern.getRotation(4));
+}
+
+TEST(PatternLibrary, BuiltIn) {
+    PatternLibrary& library = PatternLibrary::getInstance();
+    ASSERT_TRUE(library.find("unknown") == nullptr);
+    ASSERT_EQ(GameField(".#.\n..#\n###"),
+              library.find("glider")->getRotation(0));
+
+    const GameField& gun = library.find("gosper-gun")->getRotation(0);
+    ASSERT_EQ(9, gun.getWidth());
+    ASSERT_EQ(36, gun.getHeight());
+    const std::vector<std::string> names(library.getNames());
+    ASSERT_TRUE(std::is_sorted(names.begin(), names.end()));
+}
+
+TEST(PatternLibrary, LoadDirectory) {
+    const char* tempDir = std::getenv("TMPDIR");
+    std::string directory =
+        std::string(tempDir != nullptr ? tempDir : "/tmp") + "/patternsXXXXXX";
+    ASSERT_TRUE(mkdtemp(&directory[0]) != nullptr);
+    std::ofstream(directory + "/test-ship.rle") << "x = 3, y = 3\n2o$obo$b2o!";
+    std::ofstream(directory + "/test-bad.rle") << "x = 1, y = 1\n3o!";
+    std::ofstream(directory + "/test-other.txt") << "x = 1, y = 1\no!";
+
+    PatternLibrary& library = PatternLibrary::getInstance();
+    std::ostringstream errors;
+    ASSERT_EQ(1, library.loadDirectory(directory, errors));
+    ASSERT_EQ(GameField("##.\n#.#\n.##"),
+              library.find("test-ship")->getRotation(0));
+    ASSERT_TRUE(library.find("test-bad") == nullptr);
+    ASSERT_TRUE(library.find("test-other") == nullptr);
+    ASSERT_NE(std::string::npos, errors.str().find("test-bad.rle"));
+    ASSERT_EQ(0, library.loadDirectory(directory + "/no_such_directory",
+                                       errors));
+
+    std::remove((directory + "/test-ship.rle").c_str());
+    std::remove((directory + "/test-bad.rle").c_str());
+    std::remove((directory + "/test-other.txt").c_str());
+    std::remove(directory.c_str());
+}
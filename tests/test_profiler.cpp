@@ -0,0 +1,34 @@
+//
+//  test_profiler.cpp
+//  GameOfLiveTests
+//
+
+#include <sstream>
+#include "gtest/gtest.h"
+
+#include "profiler.h"
+
+TEST(Profiler, RecordAndReset) {
+    Profiler& profiler = Profiler::getInstance();
+    profiler.reset();
+    
+    profiler.record(PROFILE_STEP, 1000);
+    profiler.record(PROFILE_STEP, 3000);
+    profiler.count(COUNTER_STEPS, 2);
+    
+    std::ostringstream text;
+    profiler.writeText(text);
+    ASSERT_NE(std::string::npos, text.str().find("step: n=2 avg=2us"));
+    ASSERT_NE(std::string::npos, text.str().find("steps=2"));
+    ASSERT_EQ(std::string::npos, text.str().find("render:"));
+    
+    std::ostringstream json;
+    profiler.writeJson(json);
+    ASSERT_NE(std::string::npos, json.str().find("\"total_ns\": 4000"));
+    ASSERT_NE(std::string::npos, json.str().find("\"max_ns\": 3000"));
+    
+    profiler.reset();
+    std::ostringstream empty;
+    profiler.writeText(empty);
+    ASSERT_EQ(std::string::npos, empty.str().find("step:"));
+}
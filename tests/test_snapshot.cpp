@@ -0,0 +1,66 @@
+//
+//  test_snapshot.cpp
+//  GameOfLiveTests
+//
+
+#include <sstream>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+#include "snapshot.h"
+
+std::string toSnapshot(const GameField& field) {
+    std::ostringstream out;
+    writeSnapshot(out, field);
+    return out.str();
+}
+
+GameField fromSnapshot(const std::string& snapshot) {
+    std::istringstream in(snapshot);
+    return readSnapshot(in);
+}
+
+void testSnapshot(size_t width, size_t height, double density) {
+    GameField field(GameField::createRandom(width, height, density, width));
+    field.setBoundary(BOUNDARY_KLEIN);
+    const GameField restored(fromSnapshot(toSnapshot(field)));
+    ASSERT_EQ(field, restored);
+    ASSERT_EQ(BOUNDARY_KLEIN, restored.getBoundary());
+}
+
+TEST(Snapshot, RoundTrip) {
+    testSnapshot(0, 0, 0.5);
+    testSnapshot(5, 0, 0.5);
+    testSnapshot(1, 1, 1);
+    testSnapshot(63, 64, 0.5);
+    testSnapshot(130, 200, 0.01);
+    testSnapshot(200, 130, 1);
+    testSnapshot(300, 1000, 0);
+}
+
+TEST(Snapshot, SparseIsSmall) {
+    GameField field(1024, 1024);
+    field.setLifeAt(10, 10, true);
+    field.setLifeAt(1000, 700, true);
+    ASSERT_GT(200 + 1024 / SNAPSHOT_TILE_ROWS * 8, toSnapshot(field).size());
+}
+
+TEST(Snapshot, Damaged) {
+    const std::string snapshot(
+        toSnapshot(GameField::createRandom(100, 100, 0.3, 1)));
+    ASSERT_THROW(fromSnapshot(""), std::runtime_error);
+    ASSERT_THROW(fromSnapshot("#.#\n.#."), std::runtime_error);
+    ASSERT_THROW(fromSnapshot(snapshot.substr(0, snapshot.size() - 1)),
+                 std::runtime_error);
+    ASSERT_THROW(fromSnapshot(snapshot + "x"), std::runtime_error);
+    
+    // Width is changed, so tiles do not match the field
+    std::string wrongWidth(snapshot);
+    wrongWidth[8] = 99;
+    ASSERT_THROW(fromSnapshot(wrongWidth), std::runtime_error);
+
+    // Huge tile size is reported without reading the whole size
+    std::string wrongTile(snapshot);
+    wrongTile.replace(40, 8, "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x0F", 8);
+    ASSERT_THROW(fromSnapshot(wrongTile), std::runtime_error);
+}
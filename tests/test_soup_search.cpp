@@ -0,0 +1,43 @@
+//
+//  test_soup_search.cpp
+//  GameOfLiveTests
+//
+
+#include <sstream>
+#include "gtest/gtest.h"
+
+#include "soup_search.h"
+
+std::string censusToString(const SoupCensus& census) {
+    std::ostringstream str;
+    str << census;
+    return str.str();
+}
+
+TEST(SoupSearch, CountsAllSoups) {
+    SoupSearch search(12, 12);
+    SoupCensus census = search.run(40, 7, 2);
+    
+    ASSERT_EQ(40, census.soups);
+    size_t classified = 0;
+    for (auto count : census.states)
+        classified += count.second;
+    ASSERT_EQ(census.soups, classified + census.unstabilized);
+    ASSERT_LT(0, census.generations);
+    ASSERT_FALSE(census.objects.empty());
+}
+
+TEST(SoupSearch, IndependentOfThreads) {
+    SoupSearch search(10, 10);
+    const std::string single = censusToString(search.run(30, 123, 1));
+    ASSERT_EQ(single, censusToString(search.run(30, 123, 3)));
+    ASSERT_NE(single, censusToString(search.run(30, 124, 1)));
+}
+
+TEST(SoupSearch, EmptySoups) {
+    SoupSearch search(8, 8, 0);
+    SoupCensus census = search.run(5, 0, 2);
+    ASSERT_EQ(5, census.states["empty"]);
+    ASSERT_EQ(0, census.unstabilized);
+    ASSERT_TRUE(census.objects.empty());
+}
@@ -6,6 +6,9 @@
 //  Copyright © 2017 Кирилл. All rights reserved.
 //
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "view_handler.h"
 
 const char ALIVE_CELL = 'O';
@@ -14,6 +17,9 @@ const char NO_CELL = ' ';
 // Maximum command length in command mode
 const size_t MAX_COMMAND_LEN = 50;
 
+// Number of lines in the statistics panel
+const int STATISTICS_LINES = 6;
+
 CursesViewHandler::CursesViewHandler() {
   initscr();
 
@@ -23,6 +29,17 @@ CursesViewHandler::CursesViewHandler() {
   getchar();
 #endif
 
+  initTerminal();
+}
+
+CursesViewHandler::CursesViewHandler(FILE* output, FILE* input) {
+  screen = newterm(nullptr, output, input);
+  if (screen == nullptr)
+    throw std::runtime_error("Cannot initialize terminal");
+  initTerminal();
+}
+
+void CursesViewHandler::initTerminal() {
   clear();
   noecho();
   cbreak();
@@ -75,11 +92,51 @@ void CursesViewHandler::updateField(const GameField& field, size_t stepsCount) {
     for (int j = 0; j < field.getHeight(); j++) {
       wmove(fieldWin, j + 1, i * 2 + 1);
       wdelch(fieldWin);
-      winsch(fieldWin, field[i][j].isLife() ? ALIVE_CELL : NO_CELL);
+      winsch(fieldWin, field.isLifeAt(i, j) ? ALIVE_CELL : NO_CELL);
     }
   wrefresh(fieldWin);
 }
 
+void CursesViewHandler::updateStatistics(const GameStatistics& statistics) {
+  if (!statisticsShown) {
+    // Panel may take place of the commandline, it will be moved below
+    move(getCommandLineRow(), 0);
+    clrtobot();
+    statisticsShown = true;
+  }
+
+  int row = static_cast<int>(PROMPTS.size()) + 3;
+  const int coloumn = static_cast<int>(gameWidth) * 2 + 2;
+  mvprintw(row++, coloumn, "Gen/s: %.1f", statistics.generationsPerSecond);
+  clrtoeol();
+  mvprintw(row++, coloumn, "Step time: %.2f ms", statistics.stepMilliseconds);
+  clrtoeol();
+  mvprintw(row++, coloumn, "Render: %.2f ms", statistics.renderMilliseconds);
+  clrtoeol();
+  mvprintw(row++, coloumn, "Population: %zd", statistics.population);
+  clrtoeol();
+  mvprintw(row++, coloumn, "Active tiles: %zd", statistics.activeTiles);
+  clrtoeol();
+  mvprintw(row++, coloumn, "Memory: %zd KB", statistics.memoryBytes / 1024);
+  clrtoeol();
+
+  drawCommandLine();
+}
+
+void CursesViewHandler::clearStatistics() {
+  if (!statisticsShown)
+    return;
+  statisticsShown = false;
+
+  const int firstRow = static_cast<int>(PROMPTS.size()) + 3;
+  for (int row = firstRow; row < firstRow + STATISTICS_LINES; row++) {
+    move(row, static_cast<int>(gameWidth) * 2 + 2);
+    clrtoeol();
+  }
+
+  drawCommandLine();
+}
+
 void CursesViewHandler::updateKeyboardCursor(size_t posX, size_t posY) {
   if (posX != cursorX || posY != cursorY) {
     chtype c = mvwinch(fieldWin, cursorY + 1, cursorX * 2 + 1) & ~A_REVERSE;
@@ -119,7 +176,7 @@ void CursesViewHandler::updateCommandLine(const std::string& commandOutput) {
 }
 
 std::string CursesViewHandler::readCommandInput() {
-  move(static_cast<int>(gameHeight) + 3, 0);
+  move(getCommandLineRow() + 1, 0);
   clrtobot();
   printw(">> ");
   keypad(stdscr, FALSE);
@@ -173,6 +230,35 @@ const InputResult CursesViewHandler::waitForInput(uint8_t timeout) {
   return result;
 }
 
+const InputResult CursesViewHandler::waitForInputUntil(
+    std::chrono::steady_clock::time_point deadline) {
+  MEVENT mouse;
+  InputResult result;
+
+  // Waiting is limited by milliseconds, clicks outside the field are skipped
+  while (true) {
+    const std::chrono::milliseconds remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+    wtimeout(stdscr, std::max(0, static_cast<int>(remaining.count())));
+    const int event = getch();
+    if (event == ERR)
+      break;
+    if (event != KEY_MOUSE) {
+      result = InputResult(event);
+      break;
+    }
+    if (getmouse(&mouse) == OK && mouse.x / 2 < gameWidth &&
+        mouse.y - 1 < gameHeight) {
+      result = InputResult(mouse.x / 2, mouse.y - 1);
+      break;
+    }
+  }
+
+  wtimeout(stdscr, -1);
+  return result;
+}
+
 static size_t getMaxPromptWidth() {
   size_t max = 0;
   for (auto prompt : PROMPTS)
@@ -191,6 +277,9 @@ bool CursesViewHandler::canCrateFieldWithSizes(size_t fieldWidth,
   size_t width = fieldWidth + getMaxPromptWidth();
   size_t promptsHeight =
       PROMPTS.size() + 2;  // Offset for displaying the number of steps
+  // Statistics panel moves the command line down like in getCommandLineRow()
+  if (statisticsShown)
+    promptsHeight += STATISTICS_LINES + 1;
   size_t height = fieldHeight > promptsHeight ? fieldHeight : promptsHeight;
   height += 2;  // Offset for command mode displaying
   height += 2;  // Offset for field boards
@@ -198,8 +287,16 @@ bool CursesViewHandler::canCrateFieldWithSizes(size_t fieldWidth,
   return maxWidth >= width && maxHeight >= height;
 }
 
+int CursesViewHandler::getCommandLineRow() const {
+  int fieldHeight = static_cast<int>(gameHeight) + 2;
+  int panelHeight = static_cast<int>(PROMPTS.size()) + 2;
+  if (statisticsShown)
+    panelHeight += STATISTICS_LINES + 1;
+  return fieldHeight > panelHeight ? fieldHeight : panelHeight;
+}
+
 void CursesViewHandler::drawCommandLine() const {
-  move(static_cast<int>(gameHeight) + 2, 0);
+  move(getCommandLineRow(), 0);
   clrtobot();
   printw(commandLine.c_str());
 }
@@ -207,4 +304,6 @@ void CursesViewHandler::drawCommandLine() const {
 CursesViewHandler::~CursesViewHandler() {
   delwin(fieldWin);
   endwin();
+  if (screen != nullptr)
+    delscreen(screen);
 }
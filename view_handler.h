@@ -14,14 +14,25 @@
 #include "game_handler.h"
 
 const std::vector<std::string> PROMPTS = {
-    "Q Exit", "N Next turn", "B Step Back", "R Reset", "C Command mode"};
+    "Q Exit",  "N Next turn",    "B Step Back",
+    "R Reset", "C Command mode", "S Statistics"};
 
 class CursesViewHandler : public ViewHandler {
  public:
   CursesViewHandler();
 
+  /**
+   * Creates view on the terminal with given input and output instead of the
+   * standard one, for example to render off-screen.
+   */
+  CursesViewHandler(FILE* output, FILE* input);
+
   void updateField(const GameField& field, size_t stepsCount) override;
 
+  void updateStatistics(const GameStatistics& statistics) override;
+
+  void clearStatistics() override;
+
   void updateKeyboardCursor(size_t posX, size_t posY) override;
 
   void updateCommandLine(const std::string& commandOutput) override;
@@ -30,11 +41,17 @@ class CursesViewHandler : public ViewHandler {
 
   const InputResult waitForInput(uint8_t timeout) override;
 
+  const InputResult waitForInputUntil(
+      std::chrono::steady_clock::time_point deadline) override;
+
   bool canCrateFieldWithSizes(size_t width, size_t height) override;
 
   ~CursesViewHandler();
 
  private:
+  // Terminal created by newterm, or nullptr for the standard one
+  SCREEN* screen = nullptr;
+
   WINDOW* fieldWin;
 
   // Commandline output
@@ -48,6 +65,19 @@ class CursesViewHandler : public ViewHandler {
   size_t gameWidth = 0;
   size_t gameHeight = 0;
 
+  // Is statistics panel displayed
+  bool statisticsShown = false;
+
+  /**
+   * Sets up input modes and creates field window on the current terminal.
+   */
+  void initTerminal();
+
+  /**
+   * @return Row of the commandline below the field and the side panel.
+   */
+  int getCommandLineRow() const;
+
   void drawCommandLine() const;
 };
 